@@ -0,0 +1,86 @@
+#include "RadarGeometry.h"
+#include "RadarTaskPool.h"
+#include "bench_util.h"
+#include <cstdlib>
+#include <cstring>
+
+// keeps the generated vectors from being optimized away
+static volatile size_t sink;
+
+// Ring generation with runtime trig against the constexpr-table
+// specializations, at the segment counts generateRings dispatches on.
+// Also checks that both produce the same bytes.
+template <int Segments>
+static int benchRings(RadarGeometry &geo, int rings, int iterations)
+{
+    auto dynamic = geo.generateRingsDynamic(rings, Segments);
+    auto table = geo.generateRings<Segments>(rings);
+    int mismatches = dynamic.size() == table.size() ? 0 : 1;
+    for (size_t i = 0; !mismatches && i < dynamic.size(); i++)
+        mismatches += memcmp(&dynamic[i], &table[i], sizeof(RadarVertex)) != 0;
+
+    double dynamicMs = benchMedianMs(iterations, [&]()
+                                     { sink = geo.generateRingsDynamic(rings, Segments).size(); });
+    double tableMs = benchMedianMs(iterations, [&]()
+                                   { sink = geo.generateRings<Segments>(rings).size(); });
+
+    char name[96];
+    snprintf(name, sizeof(name), "%3d segments, runtime trig", Segments);
+    benchReport(name, dynamicMs, (double)dynamic.size(), "verts");
+    snprintf(name, sizeof(name), "%3d segments, constexpr table", Segments);
+    benchReport(name, tableMs, (double)table.size(), "verts");
+    printf("%40s speedup %.2fx, %d vertices differ\n", "", dynamicMs / tableMs, mismatches);
+    return mismatches;
+}
+
+// Large grid (offline export size) serially and split across pools of
+// increasing size; every parallel result must match the serial bytes.
+static int benchGridScaling(RadarGeometry &geo, int rings, int segment, int iterations)
+{
+    printf("grid generation, %d rings x %d segments, 36 radials\n", rings, segment);
+
+    auto serial = geo.generateGrid(rings, 36, segment);
+    double serialMs = benchMedianMs(iterations, [&]()
+                                    { sink = geo.generateGrid(rings, 36, segment).size(); });
+    benchReport("serial", serialMs, (double)serial.size(), "verts");
+
+    int mismatches = 0;
+    int hardware = (int)std::thread::hardware_concurrency();
+    for (int threads = 1; threads <= hardware; threads *= 2)
+    {
+        RadarTaskPool pool(threads - 1);
+        auto parallel = geo.generateGridParallel(rings, 36, segment, &pool);
+        bool same = parallel.size() == serial.size() &&
+                    memcmp(parallel.data(), serial.data(), serial.size() * sizeof(RadarVertex)) == 0;
+        mismatches += !same;
+
+        double ms = benchMedianMs(iterations, [&]()
+                                  { sink = geo.generateGridParallel(rings, 36, segment, &pool).size(); });
+        char name[96];
+        snprintf(name, sizeof(name), "parallel, %2d threads%s", threads, same ? "" : " (DIFFERS)");
+        benchReport(name, ms, (double)parallel.size(), "verts");
+    }
+    return mismatches;
+}
+
+// radar_bench_geometry [iterations] [rings]
+int main(int argc, char **argv)
+{
+    int iterations = argc > 1 ? atoi(argv[1]) : 200;
+    int rings = argc > 2 ? atoi(argv[2]) : 10;
+
+    printf("ring generation, %d rings, median of %d runs\n", rings, iterations);
+
+    RadarGeometry geo;
+    int mismatches = 0;
+    mismatches += benchRings<64>(geo, rings, iterations);
+    mismatches += benchRings<100>(geo, rings, iterations);
+    mismatches += benchRings<128>(geo, rings, iterations);
+    mismatches += benchRings<256>(geo, rings, iterations);
+    mismatches += benchRings<360>(geo, rings, iterations);
+
+    printf("\n");
+    mismatches += benchGridScaling(geo, 50, 8192, iterations / 10 + 1);
+
+    return mismatches ? 1 : 0;
+}
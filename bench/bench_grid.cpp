@@ -0,0 +1,129 @@
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include "RadarGeometry.h"
+#include "RadarRenderer.h"
+#include "RadarGridShader.h"
+#include "bench_util.h"
+#include <cstdlib>
+#include <functional>
+
+// Tessellated grid (GL_LINES) against the analytic fragment-shader grid:
+// draw cost, and whether both light the same pixels within one pixel.
+//
+// radar_bench_grid [frames] [width] [height]
+int main(int argc, char **argv)
+{
+    int frames = argc > 1 ? atoi(argv[1]) : 100;
+    int width = argc > 2 ? atoi(argv[2]) : 1024;
+    int height = argc > 3 ? atoi(argv[3]) : 1024;
+
+    if (!glfwInit())
+        return 1;
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    GLFWwindow *window = glfwCreateWindow(width, height, "bench", nullptr, nullptr);
+    if (!window)
+    {
+        glfwTerminate();
+        return 1;
+    }
+    glfwMakeContextCurrent(window);
+    glewExperimental = GL_TRUE;
+    glewInit();
+
+    printf("renderer: %s, %dx%d, median of %d frames\n", (const char *)glGetString(GL_RENDERER), width, height, frames);
+
+    GLuint fbo, color;
+    glGenRenderbuffers(1, &color);
+    glBindRenderbuffer(GL_RENDERBUFFER, color);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color);
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glViewport(0, 0, width, height);
+
+    const int rings = 5, radials = 12, segment = 360;
+    RadarGeometry geo;
+    RadarRenderer lines;
+    RadarGridShader shader;
+
+    std::vector<RadarVertex> grid;
+    double rebuild = benchMedianMs(frames, [&]()
+                                   {
+        grid = geo.generateRings(rings, segment);
+        auto radialVerts = geo.generateRadials(radials, segment);
+        grid.insert(grid.end(), radialVerts.begin(), radialVerts.end());
+        lines.upload(grid); });
+    benchReport("tessellated grid rebuild + upload", rebuild, 1, "rebuilds");
+
+    auto drawLines = [&]()
+    { lines.render(GL_LINES); };
+    auto drawShader = [&]()
+    { shader.render(rings, radials, RadarGeometry::RING_SPACING, geo.getGridColor(), 1.0f); };
+
+    std::vector<unsigned char> tessellated(width * height * 4), analytic(width * height * 4);
+    glClear(GL_COLOR_BUFFER_BIT);
+    drawLines();
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, tessellated.data());
+    glClear(GL_COLOR_BUFFER_BIT);
+    drawShader();
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, analytic.data());
+
+    // a pixel is lit when its green passes a small threshold; it matches when
+    // the other image has a lit pixel within one pixel of it
+    auto lit = [&](const std::vector<unsigned char> &image, int x, int y)
+    { return x >= 0 && y >= 0 && x < width && y < height && image[(y * width + x) * 4 + 1] > 20; };
+    auto near = [&](const std::vector<unsigned char> &image, int x, int y)
+    {
+        for (int dy = -1; dy <= 1; dy++)
+            for (int dx = -1; dx <= 1; dx++)
+                if (lit(image, x + dx, y + dy))
+                    return true;
+        return false;
+    };
+
+    int unmatchedLines = 0, unmatchedShader = 0;
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            if (lit(tessellated, x, y) && !near(analytic, x, y))
+                unmatchedLines++;
+            if (lit(analytic, x, y) && !near(tessellated, x, y))
+                unmatchedShader++;
+        }
+    }
+    printf("pixels off by more than 1 px: tessellated %d, analytic %d\n", unmatchedLines, unmatchedShader);
+
+    for (auto &draw : {std::make_pair("tessellated GL_LINES draw", std::function<void()>(drawLines)),
+                       std::make_pair("analytic grid draw", std::function<void()>(drawShader))})
+    {
+        double ms = benchMedianMs(frames, [&]()
+                                  {
+            glClear(GL_COLOR_BUFFER_BIT);
+            draw.second();
+            glFinish(); });
+        benchReport(draw.first, ms, 1, "frames");
+    }
+
+    // a sector only shades its bounding box
+    geo.setSector(45.0f, 135.0f, false);
+    shader.setSector(geo);
+    double sectorMs = benchMedianMs(frames, [&]()
+                                    {
+        glClear(GL_COLOR_BUFFER_BIT);
+        drawShader();
+        glFinish(); });
+    benchReport("analytic grid draw, 90 degree sector", sectorMs, 1, "frames");
+
+    glDeleteFramebuffers(1, &fbo);
+    glDeleteRenderbuffers(1, &color);
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return unmatchedLines + unmatchedShader == 0 ? 0 : 1;
+}
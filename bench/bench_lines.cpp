@@ -0,0 +1,102 @@
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include "RadarGeometry.h"
+#include "RadarRenderer.h"
+#include "RadarLineRenderer.h"
+#include "RadarMsaaTarget.h"
+#include "bench_util.h"
+#include <cstdlib>
+#include <functional>
+
+// Grid line cost: GL_LINES with and without GL_LINE_SMOOTH against the
+// quad-expanded line path at several widths, and with a 4x MSAA resolve.
+// For software numbers run under Mesa llvmpipe: LIBGL_ALWAYS_SOFTWARE=1 radar_bench_lines
+//
+// radar_bench_lines [frames] [size]
+int main(int argc, char **argv)
+{
+    int frames = argc > 1 ? atoi(argv[1]) : 100;
+    int size = argc > 2 ? atoi(argv[2]) : 1024;
+
+    if (!glfwInit())
+        return 1;
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    GLFWwindow *window = glfwCreateWindow(size, size, "bench", nullptr, nullptr);
+    if (!window)
+    {
+        glfwTerminate();
+        return 1;
+    }
+    glfwMakeContextCurrent(window);
+    glewExperimental = GL_TRUE;
+    glewInit();
+
+    printf("renderer: %s, %dx%d, median of %d frames\n", (const char *)glGetString(GL_RENDERER), size, size, frames);
+
+    // offscreen target so the window system does not take part
+    GLuint fbo, color;
+    glGenRenderbuffers(1, &color);
+    glBindRenderbuffer(GL_RENDERBUFFER, color);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, size, size);
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color);
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glViewport(0, 0, size, size);
+
+    RadarGeometry geo;
+    auto grid = geo.generateRings(10, 360);
+    auto radials = geo.generateRadials(36, 360);
+    grid.insert(grid.end(), radials.begin(), radials.end());
+
+    RadarRenderer lines;
+    lines.upload(grid);
+    RadarLineRenderer quads;
+    quads.upload(grid);
+    RadarMsaaTarget msaa;
+
+    auto run = [&](const char *name, const std::function<void()> &draw)
+    {
+        draw();
+        glFinish();
+        double ms = benchMedianMs(frames, [&]()
+                                  {
+            glClear(GL_COLOR_BUFFER_BIT);
+            draw();
+            glFinish(); });
+        benchReport(name, ms, grid.size() / 2, "segments");
+    };
+
+    run("GL_LINES", [&]()
+        { lines.render(GL_LINES); });
+
+    glEnable(GL_LINE_SMOOTH);
+    run("GL_LINES + GL_LINE_SMOOTH", [&]()
+        { lines.render(GL_LINES); });
+    glDisable(GL_LINE_SMOOTH);
+
+    for (float width : {1.0f, 2.0f, 4.0f})
+    {
+        char name[64];
+        snprintf(name, sizeof(name), "quads %.0f px", width);
+        run(name, [&]()
+            { quads.render(width, size, size); });
+    }
+
+    run("quads 1 px + 4x MSAA resolve", [&]()
+        {
+        msaa.begin(size, size, 4);
+        quads.render(1.0f, size, size);
+        msaa.resolve(0, 0); });
+
+    glDeleteFramebuffers(1, &fbo);
+    glDeleteRenderbuffers(1, &color);
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return 0;
+}
@@ -0,0 +1,141 @@
+#include "RadarPacketRing.h"
+#include "RadarSceneGenerator.h"
+#include "bench_util.h"
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Per-radar packet queues between one receive thread and a consumer per
+// radar: the lock-free RadarPacketRing against a mutex-guarded deque of
+// strings, the listener's previous queue. The producer round-robins over
+// the radars with RadarSceneGenerator spokes; consumers check that every
+// radar gets its own spokes, in order.
+
+struct MutexQueue
+{
+    std::mutex mutex;
+    std::deque<std::string> queue;
+
+    bool push(const void *data, size_t size, int64_t)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.emplace_back((const char *)data, size);
+        return true;
+    }
+    bool pop(std::string &out)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (queue.empty())
+            return false;
+        out = std::move(queue.front());
+        queue.pop_front();
+        return true;
+    }
+};
+
+// spokes of one revolution per radar, sent `packets` times in total
+template <typename Queue>
+static double run(std::vector<std::unique_ptr<Queue>> &queues, const std::vector<std::vector<std::string>> &spokes,
+                  long long packets, long long &outOfOrder, long long &dropped)
+{
+    int radars = (int)queues.size();
+    long long perRadar = packets / radars;
+    std::atomic<bool> done{false};
+    std::atomic<long long> disorder{0};
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> consumers;
+    for (int r = 0; r < radars; r++)
+    {
+        consumers.emplace_back([&, r]()
+                               {
+            std::string packet;
+            long long expected = 0;
+            for (;;)
+            {
+                if (!queues[r]->pop(packet))
+                {
+                    if (done.load(std::memory_order_acquire) && !queues[r]->pop(packet))
+                        break;
+                    std::this_thread::yield();
+                    continue;
+                }
+                RadarSpokeHeader header;
+                memcpy(&header, packet.data(), sizeof(header));
+                if (header.sequence < expected || header.radarId != r)
+                    disorder++;
+                expected = header.sequence + 1;
+            } });
+    }
+
+    dropped = 0;
+    for (long long k = 0; k < perRadar; k++)
+    {
+        for (int r = 0; r < radars; r++)
+        {
+            std::string packet = spokes[r][k % spokes[r].size()];
+            RadarSpokeHeader header;
+            memcpy(&header, packet.data(), sizeof(header));
+            header.sequence = (uint32_t)k;
+            memcpy(&packet[0], &header, sizeof(header));
+            // a full queue drops, like the receive thread does
+            while (!queues[r]->push(packet.data(), packet.size(), k))
+            {
+                dropped++;
+                std::this_thread::yield();
+            }
+        }
+    }
+    done.store(true, std::memory_order_release);
+    for (auto &consumer : consumers)
+        consumer.join();
+
+    outOfOrder = disorder.load();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char **argv)
+{
+    int radars = argc > 1 ? atoi(argv[1]) : 8;
+    long long packets = argc > 2 ? atoll(argv[2]) : 400000;
+
+    // one revolution per radar, encoded like the wire
+    std::vector<std::vector<std::string>> spokes(radars);
+    for (int r = 0; r < radars; r++)
+    {
+        RadarSceneGenerator::Config config;
+        config.seed = 100 + r;
+        config.radarId = (uint16_t)r;
+        config.spokesPerRevolution = 1024;
+        config.bins = 1024;
+        RadarSceneGenerator scene(config);
+        std::vector<uint8_t> packet(scene.maxPacketSize());
+        for (int k = 0; k < config.spokesPerRevolution; k++)
+        {
+            size_t size = scene.spoke((uint32_t)k, 0, packet.data());
+            spokes[r].emplace_back((const char *)packet.data(), size);
+        }
+    }
+    printf("%d radars, %lld packets, %u hardware threads\n", radars, packets, std::thread::hardware_concurrency());
+
+    long long outOfOrder, retries;
+    std::vector<std::unique_ptr<RadarPacketRing>> rings;
+    for (int r = 0; r < radars; r++)
+        rings.emplace_back(new RadarPacketRing(4 << 20));
+    double ringMs = run(rings, spokes, packets, outOfOrder, retries);
+    benchReport("packet ring per radar", ringMs, (double)packets, "packets");
+    printf("  %lld out of order or misrouted, %lld full-queue retries\n", outOfOrder, retries);
+
+    std::vector<std::unique_ptr<MutexQueue>> deques;
+    for (int r = 0; r < radars; r++)
+        deques.emplace_back(new MutexQueue());
+    double dequeMs = run(deques, spokes, packets, outOfOrder, retries);
+    benchReport("mutex deque per radar", dequeMs, (double)packets, "packets");
+    printf("  %lld out of order or misrouted\n", outOfOrder);
+    return 0;
+}
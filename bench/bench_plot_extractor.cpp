@@ -0,0 +1,76 @@
+#include "RadarPlotExtractor.h"
+#include "bench_util.h"
+#include <cmath>
+#include <cstdlib>
+#include <random>
+
+// Synthetic thresholded scene: N elliptic targets of a few bins by a few
+// spokes plus sparse single-cell noise, one revolution of video.
+static std::vector<uint8_t> makeScene(int azimuths, int bins, int targets, double noise, unsigned seed)
+{
+    std::vector<uint8_t> video((size_t)azimuths * bins, 0);
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    for (size_t i = 0; i < video.size(); i++)
+    {
+        if (unit(rng) < noise)
+            video[i] = (uint8_t)(20 + rng() % 60);
+    }
+
+    for (int t = 0; t < targets; t++)
+    {
+        int az = rng() % azimuths;
+        int bin = 16 + rng() % (bins - 32);
+        int halfAz = 2 + rng() % 8;
+        int halfBin = 1 + rng() % 6;
+        for (int da = -halfAz; da <= halfAz; da++)
+        {
+            for (int db = -halfBin; db <= halfBin; db++)
+            {
+                double d = (double)da * da / (halfAz * halfAz) + (double)db * db / (halfBin * halfBin);
+                if (d > 1.0)
+                    continue;
+                int row = (az + da + azimuths) % azimuths;
+                video[(size_t)row * bins + bin + db] = (uint8_t)(255 - 100 * d);
+            }
+        }
+    }
+    return video;
+}
+
+// radar_bench_plots [revolutions]
+int main(int argc, char **argv)
+{
+    int revolutions = argc > 1 ? atoi(argv[1]) : 5;
+    const int azimuths = 4096;
+    const int bins = 2048;
+
+    printf("plot extraction, %d x %d cells, median of %d revolutions\n", azimuths, bins, revolutions);
+
+    for (int targets : {100, 1000, 5000})
+    {
+        for (double noise : {0.0, 0.001, 0.01})
+        {
+            auto video = makeScene(azimuths, bins, targets, noise, 42);
+
+            RadarPlotExtractor::Config config;
+            config.azimuths = azimuths;
+            RadarPlotExtractor extractor(config);
+            std::vector<RadarPlot> plots;
+            plots.reserve(targets * 2);
+
+            double ms = benchMedianMs(revolutions, [&]()
+                                      {
+                plots.clear();
+                for (int az = 0; az < azimuths; az++)
+                    extractor.addSpoke(az, video.data() + (size_t)az * bins, bins, plots); });
+            extractor.flush(plots);
+
+            char name[96];
+            snprintf(name, sizeof(name), "targets %5d noise %.3f (%zu plots)", targets, noise, plots.size());
+            benchReport(name, ms, azimuths, "spokes");
+        }
+    }
+    return 0;
+}
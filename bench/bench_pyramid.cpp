@@ -0,0 +1,83 @@
+#include "RadarPolarPyramid.h"
+#include "RadarScanConverter.h"
+#include "bench_util.h"
+#include <cstdlib>
+#include <cstring>
+
+// keeps results from being optimized away
+static volatile int sink;
+
+// Max-preserving polar pyramid: per-spoke update cost against a full
+// build, the reduction kernel against a scalar reference, and how many
+// one-cell targets a zoomed-out CPU scan conversion keeps with and
+// without the pyramid.
+int main(int argc, char **argv)
+{
+    int azimuths = argc > 1 ? atoi(argv[1]) : 4096;
+    int bins = argc > 2 ? atoi(argv[2]) : 2048;
+    int scope = argc > 3 ? atoi(argv[3]) : 400;
+    int iterations = 50;
+
+    RadarPolarImage image(azimuths, bins);
+    srand(7);
+    for (auto &cell : image.data)
+        cell = (uint8_t)(rand() % 24);
+
+    // reduction kernel against the plain definition
+    int mismatches = 0;
+    std::vector<uint8_t> fast((bins + 1) / 2), reference((bins + 1) / 2);
+    for (int row = 0; row + 1 < azimuths; row += 2)
+    {
+        const uint8_t *a = image.row(row), *b = image.row(row + 1);
+        RadarPolarPyramid::reduceRows(a, b, fast.data(), bins);
+        for (int i = 0; i < (bins + 1) / 2; i++)
+        {
+            uint8_t m = std::max(a[2 * i], b[2 * i]);
+            if (2 * i + 1 < bins)
+                m = std::max(m, std::max(a[2 * i + 1], b[2 * i + 1]));
+            reference[i] = m;
+        }
+        mismatches += memcmp(fast.data(), reference.data(), reference.size()) != 0;
+    }
+
+    RadarPolarPyramid pyramid;
+    printf("%d azimuths x %d bins, %d scope pixels\n", azimuths, bins, scope);
+    double buildMs = benchMedianMs(iterations / 5, [&]()
+                                   { pyramid.build(image); });
+    benchReport("pyramid build", buildMs, (double)azimuths * bins, "cells");
+
+    // a revolution's worth of spokes, one updateRow each
+    double spokeMs = benchMedianMs(iterations / 5, [&]()
+                                   {
+        for (int row = 0; row < azimuths; row++)
+            pyramid.updateRow(image, row); });
+    benchReport("pyramid update, spoke by spoke", spokeMs, (double)azimuths * bins, "cells");
+    printf("%d levels, %d reduced rows differ from the scalar reference\n", pyramid.getLevelCount(), mismatches);
+
+    // one-cell targets at random cells, then zoomed-out conversion
+    const int TARGETS = 200;
+    for (int t = 0; t < TARGETS; t++)
+    {
+        int az = rand() % azimuths;
+        int bin = bins / 8 + rand() % (bins - bins / 8);
+        image.row(az)[bin] = 255;
+        pyramid.updateRow(image, az);
+    }
+
+    RadarScanConverter converter;
+    std::vector<uint8_t> pixels((size_t)scope * scope);
+    const char *names[2] = {"scan convert, full image", "scan convert, pyramid level"};
+    for (int usePyramid = 0; usePyramid < 2; usePyramid++)
+    {
+        const RadarPolarPyramid *levels = usePyramid ? &pyramid : nullptr;
+        double ms = benchMedianMs(iterations, [&]()
+                                  { converter.convert(image, levels, scope, scope, pixels.data()); sink = pixels[0]; });
+        int bright = 0;
+        for (uint8_t p : pixels)
+            bright += p == 255;
+        benchReport(names[usePyramid], ms, (double)scope * scope, "px");
+        printf("%40s level %d, %d target pixels for %d targets\n", "", converter.getLevel(), bright, TARGETS);
+    }
+
+    return mismatches ? 1 : 0;
+}
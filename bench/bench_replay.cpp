@@ -0,0 +1,140 @@
+#include "RadarPacketRing.h"
+#include "RadarRecorder.h"
+#include "RadarReplay.h"
+#include "RadarSceneGenerator.h"
+#include "RadarSpokeCodec.h"
+#include "bench_util.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <thread>
+
+// Max-speed replay as the throughput benchmark: records `seconds` of
+// RadarSceneGenerator spokes, then replays them with speed 0 into the
+// pipeline the main app feeds, a per-source RadarPacketRing drained by a
+// consumer thread that parses and decodes every spoke. Exits non-zero below
+// 10x real time, or if replay allocates on the heap per packet (counted
+// with a replaced operator new while the replay runs).
+
+static std::atomic<bool> countAllocations{false};
+static std::atomic<uint64_t> allocations{0};
+
+void *operator new(size_t size)
+{
+    if (countAllocations.load(std::memory_order_relaxed))
+        allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    free(p);
+}
+
+int main(int argc, char **argv)
+{
+    double seconds = argc > 1 ? atof(argv[1]) : 20.0;
+    std::string path = argc > 2 ? argv[2] : "radar_bench_replay.rec";
+
+    RadarSceneGenerator::Config scene;
+    RadarSceneGenerator generator(scene);
+    long long count = (long long)(seconds / generator.getSpokeInterval());
+    {
+        RadarRecorder recorder;
+        if (!recorder.open(path))
+        {
+            printf("cannot open %s\n", path.c_str());
+            return 1;
+        }
+        std::vector<uint8_t> packet(generator.maxPacketSize());
+        for (long long k = 0; k < count; k++)
+        {
+            int64_t timestamp = (int64_t)(k * generator.getSpokeInterval() * 1e9);
+            size_t size = generator.spoke((uint32_t)k, timestamp, packet.data());
+            recorder.write(packet.data(), (uint32_t)size, timestamp);
+        }
+        recorder.close();
+    }
+
+    RadarReplay replay;
+    if (!replay.open(path))
+        return 1;
+    uint64_t packets = replay.getPacketCount();
+    double recorded = (replay.getLastTimestamp() - replay.getFirstTimestamp()) / 1e9;
+    printf("%llu packets, %.1f s of %d x %d video, %u hardware threads\n", (unsigned long long)packets,
+           recorded, scene.spokesPerRevolution, scene.bins, std::thread::hardware_concurrency());
+
+    // a stop before play starts, as on a quick shutdown, is honoured
+    replay.stop();
+    uint64_t early = replay.play([](const RadarPacketView &) {}, 0.0);
+    replay.open(path);
+
+    RadarPacketRing ring(4 << 20);
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> decoded{0};
+    std::vector<uint8_t> cells(scene.bins);
+    std::thread consumer([&]()
+                         {
+        size_t size;
+        int64_t timestamp;
+        for (;;)
+        {
+            const uint8_t *packet = ring.front(size, timestamp);
+            if (!packet)
+            {
+                if (done.load(std::memory_order_acquire) && !ring.front(size, timestamp))
+                    break;
+                std::this_thread::yield();
+                continue;
+            }
+            RadarSpokeHeader spoke;
+            const uint8_t *payload = radarParseSpoke(packet, size, spoke);
+            if (payload && spoke.bins <= (int)cells.size() && spoke.encoding == RADAR_SPOKE_PACKBITS &&
+                RadarSpokeCodec::decode(payload, spoke.payloadSize, cells.data(), spoke.bins) > 0)
+                decoded.fetch_add(1, std::memory_order_relaxed);
+            ring.pop();
+        } });
+
+    countAllocations = true;
+    auto start = std::chrono::steady_clock::now();
+    uint64_t delivered = replay.play([&](const RadarPacketView &packet)
+                                     {
+        // waits for the consumer instead of dropping, so every packet counts
+        while (!ring.push(packet.data, packet.size, packet.timestamp))
+            std::this_thread::yield(); },
+                                     0.0);
+    done.store(true, std::memory_order_release);
+    consumer.join();
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    countAllocations = false;
+    replay.close();
+    remove(path.c_str());
+
+    double speedup = recorded * 1000.0 / ms;
+    benchReport("replay at max speed, parsed and decoded", ms, (double)delivered, "packets");
+    printf("  %.1fx real time (need 10x), %llu decoded, %llu heap allocations while replaying\n", speedup,
+           (unsigned long long)decoded.load(), (unsigned long long)allocations.load());
+
+    bool ok = true;
+    if (early != 0)
+    {
+        printf("FAIL stop before play delivered %llu packets\n", (unsigned long long)early);
+        ok = false;
+    }
+    if (delivered != packets || decoded.load() != delivered)
+    {
+        printf("FAIL %llu of %llu packets decoded\n", (unsigned long long)decoded.load(), (unsigned long long)packets);
+        ok = false;
+    }
+    if (speedup < 10.0 || allocations.load() > 0)
+        ok = false;
+    return ok ? 0 : 1;
+}
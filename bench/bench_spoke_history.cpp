@@ -0,0 +1,188 @@
+#include "RadarPolarImage.h"
+#include "RadarSceneGenerator.h"
+#include "RadarSpokeHistory.h"
+#include "bench_util.h"
+#include <atomic>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+// Time scrubbing through RadarSpokeHistory: fills it with revolutions of
+// 2048 x 1024 RadarSceneGenerator video under a memory budget small enough
+// that most of them are spilled, then jumps to random past revolutions and
+// times the full reconstruct against the 100 ms target. The jumps run while
+// a live thread keeps adding spokes, whose worst addSpoke shows whether the
+// history lock is held across spill file I/O. Last, a reconstruct loop
+// races a writer that keeps pushing turns out of a two-turn budget, so
+// spills are claimed and written while the turn is being reconstructed;
+// every image must match the same moment rebuilt once the writer stops.
+
+static double percentile(std::vector<double> v, double p)
+{
+    std::sort(v.begin(), v.end());
+    return v[(size_t)(p * (v.size() - 1))];
+}
+
+static uint64_t imageHash(const RadarPolarImage &image)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (uint8_t byte : image.data)
+        hash = (hash ^ byte) * 1099511628211ull;
+    return hash;
+}
+
+int main(int argc, char **argv)
+{
+    int revolutions = argc > 1 ? atoi(argv[1]) : 40;
+    size_t budgetMb = argc > 2 ? (size_t)atoll(argv[2]) : 16;
+    std::string spillPath = argc > 3 ? argv[3] : "radar_bench_history.spill";
+    int jumps = 50;
+    revolutions = std::max(revolutions, 3);
+
+    RadarSceneGenerator::Config scene;
+    scene.spokesPerRevolution = 2048;
+    scene.bins = 1024;
+    RadarSceneGenerator generator(scene);
+    double interval = generator.getSpokeInterval();
+    int64_t period = (int64_t)(interval * scene.spokesPerRevolution * 1e9);
+
+    RadarSpokeHistory::Config config;
+    config.azimuths = scene.spokesPerRevolution;
+    config.bins = scene.bins;
+    config.memoryBudget = budgetMb << 20;
+    config.spillPath = spillPath;
+    RadarSpokeHistory history(config);
+
+    printf("%d revolutions of %d x %d, %zu MB budget, %u hardware threads\n", revolutions,
+           config.azimuths, config.bins, budgetMb, std::thread::hardware_concurrency());
+
+    // amplitudes with the sender's azimuth, as the receive path hands them over
+    std::vector<uint8_t> cells(scene.bins);
+    auto add = [&](uint32_t sequence)
+    {
+        generator.amplitudes(sequence, cells.data());
+        float azimuth = 360.0f * (sequence % scene.spokesPerRevolution) / scene.spokesPerRevolution;
+        auto start = std::chrono::steady_clock::now();
+        history.addSpoke(azimuth, (int64_t)(sequence * interval * 1e9), cells.data(), scene.bins);
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    uint32_t sequence = 0;
+    uint32_t filled = (uint32_t)revolutions * scene.spokesPerRevolution;
+    // scene generation is not timed, only the history
+    double fillMax = 0.0, fillMs = 0.0;
+    for (; sequence < filled; sequence++)
+    {
+        double ms = add(sequence);
+        fillMs += ms;
+        fillMax = std::max(fillMax, ms);
+    }
+    benchReport("addSpoke while filling", fillMs, (double)filled, "spokes");
+    printf("  worst addSpoke %.2f ms, %zu turns kept, %.1f MB in memory\n", fillMax,
+           history.getRevolutionCount(), history.getMemoryInUse() / 1048576.0);
+
+    // live spokes keep coming while the operator scrubs
+    std::atomic<bool> scrubbing{true};
+    std::atomic<uint32_t> liveSpokes{0};
+    double liveMax = 0.0;
+    std::thread live([&]()
+                     {
+        uint32_t s = sequence;
+        while (scrubbing.load(std::memory_order_relaxed))
+        {
+            liveMax = std::max(liveMax, add(s++));
+            liveSpokes.fetch_add(1, std::memory_order_relaxed);
+            // about twice the scene antenna's spoke rate
+            std::this_thread::sleep_for(std::chrono::microseconds(500));
+        } });
+
+    std::vector<double> times;
+    RadarPolarImage image;
+    srand(7);
+    for (int j = 0; j < jumps; j++)
+    {
+        // the end of a whole past turn, so every row changes from the previous jump
+        int back = 1 + rand() % (revolutions - 2);
+        int64_t moment = history.getRevolutionStart(back) + period - 1;
+        auto start = std::chrono::steady_clock::now();
+        bool ok = history.reconstruct(moment, image);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (ok)
+            times.push_back(ms);
+    }
+    scrubbing = false;
+    live.join();
+
+    if (times.empty())
+    {
+        printf("no jump landed in the history\n");
+        return 1;
+    }
+    printf("%-40s p50 %.2f  p95 %.2f  max %.2f ms over %zu jumps (target < 100 ms)\n", "jump to a past revolution",
+           percentile(times, 0.5), percentile(times, 0.95), percentile(times, 1.0), times.size());
+    printf("  live addSpoke during jumps: worst %.2f ms over %u spokes\n", liveMax, liveSpokes.load());
+
+    // one turn of rows, rotated per turn so turns differ, keeps the writer's
+    // time in the history rather than in the scene
+    std::vector<uint8_t> rows((size_t)scene.spokesPerRevolution * scene.bins);
+    for (int az = 0; az < scene.spokesPerRevolution; az++)
+        generator.amplitudes((uint32_t)az, rows.data() + (size_t)az * scene.bins);
+    auto addTo = [&](RadarSpokeHistory &h, uint32_t s)
+    {
+        uint32_t az = s % scene.spokesPerRevolution, turn = s / scene.spokesPerRevolution;
+        const uint8_t *row = rows.data() + (size_t)((az + turn * 97) % scene.spokesPerRevolution) * scene.bins;
+        h.addSpoke(360.0f * az / scene.spokesPerRevolution, (int64_t)(s * interval * 1e9), row, scene.bins);
+    };
+
+    // a turn's coded spokes and index, measured
+    size_t turnBytes;
+    {
+        RadarSpokeHistory::Config probeConfig = config;
+        probeConfig.spillPath.clear();
+        RadarSpokeHistory probe(probeConfig);
+        for (uint32_t s = 0; s < (uint32_t)scene.spokesPerRevolution; s++)
+            addTo(probe, s);
+        turnBytes = probe.getMemoryInUse();
+    }
+
+    // one and a half turns of spokes, so the newest complete turn keeps
+    // going out and coming back, plus the index of every turn so none is dropped
+    const uint32_t raceTurns = 64;
+    RadarSpokeHistory::Config raceConfig = config;
+    raceConfig.memoryBudget = turnBytes * 3 / 2 + raceTurns * (size_t)config.azimuths * 32;
+    raceConfig.spillPath = spillPath + ".race";
+    RadarSpokeHistory race(raceConfig);
+    uint32_t raceSequence = 0;
+    for (; raceSequence < 2u * scene.spokesPerRevolution; raceSequence++)
+        addTo(race, raceSequence);
+
+    std::atomic<bool> writing{true};
+    std::thread writer([&]()
+                       {
+        for (uint32_t s = raceSequence; s < raceTurns * scene.spokesPerRevolution; s++)
+            addTo(race, s);
+        writing = false; });
+
+    // the newest complete turn, the next one the writer spills
+    std::vector<std::pair<int64_t, uint64_t>> seen;
+    while (writing.load())
+    {
+        int64_t moment = race.getRevolutionStart(1) + period - 1;
+        std::fill(image.rowVersion.begin(), image.rowVersion.end(), 0);
+        if (race.reconstruct(moment, image))
+            seen.push_back({moment, imageHash(image)});
+    }
+    writer.join();
+
+    int mismatches = 0;
+    for (const auto &s : seen)
+    {
+        std::fill(image.rowVersion.begin(), image.rowVersion.end(), 0);
+        if (!race.reconstruct(s.first, image) || imageHash(image) != s.second)
+            mismatches++;
+    }
+    printf("%-40s %zu reconstructs, %d differ from the settled history\n", "reconstruct during spills", seen.size(),
+           mismatches);
+
+    return percentile(times, 1.0) < 100.0 && mismatches == 0 ? 0 : 1;
+}
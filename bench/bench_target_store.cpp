@@ -0,0 +1,175 @@
+#include "RadarTargetStore.h"
+#include "bench_util.h"
+#include <cmath>
+#include <cstdlib>
+#include <random>
+
+// Sweep gating with RadarTargetStore. First checks the crossings, exiting
+// non-zero on a mismatch:
+//  - a revolution cut into frames crosses every target exactly once, in
+//    both sweep directions and from start angles on either side of north,
+//    including targets on frame edges and at 0 / 360
+//  - random intervals agree with a brute-force test of every target
+// then times the indexed lookup against scanning all targets every frame.
+
+static double wrap(double angle)
+{
+    angle = std::fmod(angle, 360.0);
+    return angle < 0.0 ? angle + 360.0 : angle;
+}
+
+// crossed by a leading edge moving from `from` to `to`: after the start, up to and including the end
+static bool crossedBrute(double azimuth, double from, double to, int direction)
+{
+    double distance = direction < 0 ? wrap(from - azimuth) : wrap(azimuth - from);
+    double span = direction < 0 ? wrap(from - to) : wrap(to - from);
+    return distance > 0.0 && distance <= span;
+}
+
+static RadarPlot plotAt(float azimuth)
+{
+    RadarPlot plot = {};
+    plot.azimuth = azimuth;
+    plot.range = 100.0f;
+    return plot;
+}
+
+static int failures = 0;
+
+static void expect(bool ok, const char *what, double a, double b, int direction)
+{
+    if (ok)
+        return;
+    if (failures++ < 10)
+        printf("FAIL %s (%.6f, %.6f, direction %d)\n", what, a, b, direction);
+}
+
+// every target crossed exactly once over `frames` frames of one revolution
+static void checkRevolution(RadarTargetStore &store, const std::vector<float> &edges, int direction)
+{
+    std::vector<int> hits(store.size(), 0);
+    std::vector<uint32_t> out;
+    for (size_t f = 0; f + 1 < edges.size(); f++)
+    {
+        out.clear();
+        store.cross(edges[f], edges[f + 1], direction, 0.0, out);
+        for (uint32_t id : out)
+            hits[id]++;
+    }
+    for (size_t id = 0; id < hits.size(); id++)
+        expect(hits[id] == 1, "revolution crosses once", store.get((uint32_t)id).plot.azimuth, edges[0], direction);
+}
+
+int main(int argc, char **argv)
+{
+    int targetCount = argc > 1 ? atoi(argv[1]) : 100000;
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> angle(0.0f, 360.0f);
+
+    // --- crossings
+    const float starts[] = {0.0f, 0.5f, 90.0f, 359.5f, 359.99997f};
+    const int frameCounts[] = {1, 3, 60, 361};
+    for (int direction : {-1, 1})
+    {
+        for (float start : starts)
+        {
+            for (int frames : frameCounts)
+            {
+                std::vector<float> edges;
+                for (int f = 0; f < frames; f++)
+                    edges.push_back((float)wrap(start + direction * 360.0 * f / frames));
+                // the last frame ends exactly where the first started
+                edges.push_back(start);
+
+                RadarTargetStore store;
+                for (int k = 0; k < 500; k++)
+                    store.add(plotAt(angle(rng)));
+                // on the edges, at north and just below it
+                for (float edge : edges)
+                    store.add(plotAt(edge));
+                store.add(plotAt(0.0f));
+                store.add(plotAt(360.0f));
+                store.add(plotAt(359.99997f));
+                if (frames > 1)
+                    checkRevolution(store, edges, direction);
+            }
+        }
+    }
+
+    {
+        RadarTargetStore store;
+        std::vector<float> azimuths;
+        for (int k = 0; k < 2000; k++)
+        {
+            azimuths.push_back(angle(rng));
+            store.add(plotAt(azimuths.back()));
+        }
+        std::vector<uint32_t> out;
+        for (int trial = 0; trial < 2000; trial++)
+        {
+            int direction = trial % 2 ? 1 : -1;
+            float from = angle(rng);
+            float to = (float)wrap(from + direction * angle(rng) * 0.25f);
+            out.clear();
+            store.cross(from, to, direction, 0.0, out);
+            std::vector<bool> got(azimuths.size(), false);
+            for (uint32_t id : out)
+                got[id] = true;
+            for (size_t id = 0; id < azimuths.size(); id++)
+            {
+                // float vs double rounding on the very edge is not a disagreement
+                double a = azimuths[id];
+                if (std::fabs(wrap(a - from + 180.0) - 180.0) < 1e-3 || std::fabs(wrap(a - to + 180.0) - 180.0) < 1e-3)
+                    continue;
+                expect(got[id] == crossedBrute(a, from, to, direction), "interval matches brute force", from, to, direction);
+            }
+        }
+
+        // a frame of a full turn or more crosses everything
+        out.clear();
+        store.cross(10.0f, 10.0f, -1, 0.0, out, 360.0f);
+        expect(out.size() == azimuths.size(), "full turn crosses all", 10.0, 10.0, -1);
+    }
+
+    if (failures > 0)
+    {
+        printf("%d crossing checks failed\n", failures);
+        return 1;
+    }
+    printf("crossings: both directions, wrap at north, frame edges ok\n");
+
+    // --- per-frame cost, a 60 deg/s sweep at 60 fps crosses 1 degree per frame
+    RadarTargetStore store;
+    std::vector<float> azimuths;
+    for (int k = 0; k < targetCount; k++)
+    {
+        azimuths.push_back(angle(rng));
+        store.add(plotAt(azimuths.back()));
+    }
+    const int frames = 3600;
+    std::vector<uint32_t> out;
+    size_t crossed = 0;
+    double indexedMs = benchMedianMs(5, [&]()
+                                     {
+        crossed = 0;
+        for (int f = 0; f < frames; f++)
+        {
+            out.clear();
+            store.cross((float)wrap(-f * 1.0), (float)wrap(-(f + 1) * 1.0), -1, f / 60.0, out);
+            crossed += out.size();
+        } });
+    double scanMs = benchMedianMs(5, [&]()
+                                  {
+        for (int f = 0; f < frames; f++)
+        {
+            out.clear();
+            double from = wrap(-f * 1.0), to = wrap(-(f + 1) * 1.0);
+            for (size_t id = 0; id < azimuths.size(); id++)
+                if (crossedBrute(azimuths[id], from, to, -1))
+                    out.push_back((uint32_t)id);
+        } });
+    printf("%d targets, %d frames, %zu crossings\n", targetCount, frames, crossed);
+    benchReport("indexed cross per frame", indexedMs, (double)frames, "frames");
+    benchReport("scan of every target per frame", scanMs, (double)frames, "frames");
+    return 0;
+}
@@ -0,0 +1,31 @@
+#ifndef bench_util_h
+#define bench_util_h
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+// run fn `iterations` times and report the median, which is steadier than
+// the mean on a busy machine
+template <typename Fn>
+double benchMedianMs(int iterations, Fn fn)
+{
+    std::vector<double> times;
+    for (int i = 0; i < iterations; i++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        auto end = std::chrono::steady_clock::now();
+        times.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+inline void benchReport(const char *name, double ms, double items, const char *unit)
+{
+    printf("%-40s %10.3f ms  %12.0f %s/s\n", name, ms, items / (ms / 1000.0), unit);
+}
+
+#endif
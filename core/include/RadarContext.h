@@ -1,16 +1,170 @@
 #ifndef RadarContext_h
 #define RadarContext_h
 
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
 #include "RadarGeometry.h"
+#include "RadarSeqLock.h"
+#include "RadarGridLabels.h"
 #include "RadarRenderer.h"
+#include "RadarLayerCache.h"
+#include "RadarGridShader.h"
+#include "RadarLineRenderer.h"
+#include "RadarMsaaTarget.h"
+#include "RadarPolarImage.h"
+#include "RadarVideoRenderer.h"
+#include "RadarPresentProbe.h"
 
-struct RadarContext
+// everything the static grid layer depends on
+struct RadarGridParams
 {
-    RadarGeometry *geo;
-    RadarRenderer *ringRenderer = nullptr;
-    RadarRenderer *radialRenderer = nullptr;
-    RadarRenderer *sweepRenderer = nullptr;
-    double lastTime;
+    int rings = 0;
+    int radials = 0;
+    int segment = 0;
+    Vec4 gridColor;
+    // RadarGeometry::setSector arguments, start == end for the full circle
+    float sectorStart = 0.0f;
+    float sectorEnd = 0.0f;
+    int sectorScan = 0;
+
+    // FNV-1a over the fields, cheap enough to run on every setter call
+    uint64_t hash() const
+    {
+        uint64_t h = 1469598103934665603ull;
+        auto mix = [&h](const void *data, size_t size)
+        {
+            const unsigned char *p = static_cast<const unsigned char *>(data);
+            for (size_t i = 0; i < size; i++)
+            {
+                h ^= p[i];
+                h *= 1099511628211ull;
+            }
+        };
+
+        mix(&rings, sizeof(rings));
+        mix(&radials, sizeof(radials));
+        mix(&segment, sizeof(segment));
+        mix(&gridColor, sizeof(gridColor));
+        mix(&sectorStart, sizeof(sectorStart));
+        mix(&sectorEnd, sizeof(sectorEnd));
+        mix(&sectorScan, sizeof(sectorScan));
+        return h;
+    }
+};
+
+// state change recorded by any thread, coalesced and applied by radar_render
+struct RadarCommand
+{
+    enum Type : uint32_t
+    {
+        SetGrid,
+        SetColors,
+        SetStaticCache,
+        SetLineStyle,
+        SetAnalyticGrid,
+        SetGridLabels,
+        SetSector,
+        SetVideoColor,
+        Count
+    };
+
+    Type type;
+    union
+    {
+        struct
+        {
+            int rings;
+            int radials;
+            int segment;
+        } grid;
+        struct
+        {
+            float grid[4];
+            float sweep[4];
+        } colors;
+        int enabled;
+        struct
+        {
+            float width;
+            int samples;
+        } line;
+        struct
+        {
+            int enabled;
+            float range;
+        } labels;
+        struct
+        {
+            float start;
+            float end;
+            int scan;
+        } sector;
+        float videoColor[4];
+    };
+};
+static_assert(std::is_trivially_copyable<RadarCommand>::value, "commands are copied through a sequence lock");
+
+// One scope, built in place in a RadarHandlePool slot: geometry, renderers
+// and the command queue live inline in a single allocation. Fields read on
+// every radar_render come first so they share the slot's first cache lines.
+struct alignas(64) RadarContext
+{
+    RadarContext(int rings, int radials, int segment, float sweepSpeed, float tolerance)
+        : geo(sweepSpeed, 0, tolerance)
+    {
+        gridParams.rings = rings;
+        gridParams.radials = radials;
+        gridParams.segment = segment;
+        gridParams.gridColor = geo.getGridColor();
+    }
+
+    // change tracking, setters that match these are no-ops
+    uint64_t gridHash = 0;
+    float lastSweepAngle = 0.0f;
+    uint32_t lastParamVersion = 0;
+    bool gridDirty = true;
+    bool sweepDirty = true;
+
+    // grid lines as anti-aliased quads when lineWidth > 0, plain GL_LINES otherwise
+    float lineWidth = 0.0f;
+    // multisampled drawing resolved once per frame when msaaSamples > 1
+    int msaaSamples = 0;
+
+    // optional layers, created when enabled
+    // grid rendered once to a texture and blitted each frame
+    RadarLayerCache *staticLayer = nullptr;
+    RadarLineRenderer *gridLines = nullptr;
+    // grid computed per pixel from the parameters instead of tessellated
+    RadarGridShader *gridShader = nullptr;
+    // range and bearing labels, drawn in the same GL_LINES batch as the radials
+    RadarGridLabels *gridLabels = nullptr;
+    RadarMsaaTarget *msaa = nullptr;
+    // polar video under the sweep, clipped to the sector, created by the first upload
+    RadarVideoRenderer *video = nullptr;
+    RadarPolarImage videoImage;
+    Vec4 videoColor{1.0f, 1.0f, 0.0f, 1.0f};
+    // traced rows uploaded since the last radar_present, and the GPU query
+    // that closes their latency, created by the first radar_present
+    RadarLatencyTracker::Frame latencyFrame;
+    RadarPresentProbe *presentProbe = nullptr;
+
+    // GL objects are created by the first radar_render, on the render thread;
+    // the three renderers share one program
+    unsigned int program = 0;
+    RadarRenderer ringRenderer{RadarRenderer::Deferred()};
+    RadarRenderer radialRenderer{RadarRenderer::Deferred()};
+    RadarRenderer sweepRenderer{RadarRenderer::Deferred()};
+
+    RadarGridParams gridParams;
+    RadarGeometry geo;
+
+    // latest command of each type, written from any thread and applied at the
+    // start of radar_render; a newer write replaces an unapplied one, so
+    // bursts of setter calls can never lose the final value
+    RadarSeqLock<RadarCommand> commands[RadarCommand::Count];
+    // sequence of each slot when it was last applied, render thread only
+    uint32_t appliedCommand[RadarCommand::Count] = {};
 };
 
-#endif
\ No newline at end of file
+#endif
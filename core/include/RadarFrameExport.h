@@ -0,0 +1,80 @@
+#ifndef RadarFrameExport_H
+#define RadarFrameExport_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "RadarFrameRing.h"
+#include "RadarTypes.h"
+
+// Mapping of a named shared-memory region, common to writer and reader
+class RadarSharedRegion
+{
+public:
+    ~RadarSharedRegion() { close(); }
+
+    bool create(const std::string &name, size_t size);
+    bool open(const std::string &name);
+    void close();
+
+    uint8_t *data() const { return base; }
+    size_t size() const { return length; }
+
+private:
+    uint8_t *base = nullptr;
+    size_t length = 0;
+    std::string name;
+    bool owner = false;
+#ifdef _WIN32
+    void *mapping = nullptr;
+#endif
+};
+
+// Writer side of the frame ring (RadarFrameRing.h). Geometry snapshots and
+// read-back frames are written straight into shared memory, so other
+// processes map the ring and consume frames without copies or sockets.
+// Only one thread may write to a ring.
+class RadarFrameExport
+{
+public:
+    bool create(const std::string &name, int slotCount, size_t slotSize);
+    void close() { region.close(); }
+    bool isOpen() const { return region.data() != nullptr; }
+
+    // claim the next slot and mark it as being written; fill the header fields
+    // and payload, then publish with endWrite. nullptr if the ring is closed.
+    RadarFrameSlotHeader *beginWrite(uint32_t kind);
+    uint8_t *payload(RadarFrameSlotHeader *slot) const { return reinterpret_cast<uint8_t *>(slot + 1); }
+    size_t getSlotSize() const;
+    void endWrite(RadarFrameSlotHeader *slot);
+
+    // convenience for a whole vertex array, false if it does not fit a slot
+    bool writeVertices(const std::vector<RadarVertex> &verts, float angle);
+
+    static int64_t now();
+
+private:
+    RadarSharedRegion region;
+    RadarFrameSlotHeader *slotAt(uint64_t index) const;
+};
+
+// Reader side, for consumers written in C++
+class RadarFrameReader
+{
+public:
+    bool open(const std::string &name);
+    void close() { region.close(); }
+
+    // frames published so far, the newest has this frameId
+    uint64_t getPublished() const;
+
+    // copy the newest frame; false if there is none yet or the writer kept
+    // overwriting it for `retries` attempts
+    bool readLatest(RadarFrameSlotHeader &header, std::vector<uint8_t> &payload, int retries = 8) const;
+
+private:
+    RadarSharedRegion region;
+};
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef RadarFrameRing_H
+#define RadarFrameRing_H
+
+#include <stdint.h>
+
+/*
+ * Layout of the shared-memory frame ring written by RadarFrameExport.
+ * Plain C so readers in other processes and languages can use it as is.
+ *
+ * region: RadarFrameRingHeader, then slotCount slots of slotStride bytes
+ * slot:   RadarFrameSlotHeader, then up to slotSize payload bytes
+ *
+ * A single writer fills slots round robin. Each slot is guarded by a
+ * sequence lock: `sequence` is odd while the slot is written. To read:
+ *   1. load sequence (acquire), skip the slot if it is odd
+ *   2. read the header fields and payload (in place or copied)
+ *   3. acquire fence, load sequence again; if it changed, discard and retry
+ * `published` counts finished frames, the newest is in slot
+ * (published - 1) % slotCount and carries frameId == published.
+ */
+
+/* POSIX: shm_open("/<name>"), Windows: named file mapping "Local\<name>" */
+static const uint32_t RADAR_FRAME_RING_MAGIC = 0x47524652; /* "RFRG" */
+static const uint32_t RADAR_FRAME_RING_VERSION = 1;
+
+enum RadarFrameKind
+{
+    RADAR_FRAME_GEOMETRY = 1, /* RadarVertex array (2 + 4 floats each) */
+    RADAR_FRAME_RGBA = 2      /* width * height RGBA8 pixels, bottom row first */
+};
+
+struct RadarFrameRingHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slotCount;
+    uint32_t slotSize;   /* payload capacity of one slot */
+    uint32_t slotStride; /* header + payload, 64-byte aligned */
+    uint32_t reserved0;
+    uint64_t published; /* updated atomically after each frame */
+    uint64_t reserved[4];
+};
+
+struct RadarFrameSlotHeader
+{
+    uint32_t sequence; /* seqlock, odd while the slot is written */
+    uint32_t kind;     /* RadarFrameKind */
+    uint64_t frameId;
+    int64_t timestamp; /* nanoseconds, steady clock of the writer */
+    uint32_t width;    /* RGBA only */
+    uint32_t height;
+    uint32_t count; /* vertices, geometry only */
+    uint32_t size;  /* payload bytes */
+    float angle;    /* sweep angle of the frame, degrees */
+    uint32_t reserved[5];
+};
+
+#ifdef __cplusplus
+static_assert(sizeof(RadarFrameRingHeader) == 64 && sizeof(RadarFrameSlotHeader) == 64,
+              "frame ring headers are part of a cross-process layout");
+#endif
+
+#endif
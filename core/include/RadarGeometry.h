@@ -1,13 +1,30 @@
 #ifndef RadarGeometry_H
 #define RadarGeometry_H
 
+#include <cstdint>
 #include <vector>
 #include "RadarTypes.h"
+#include "RadarSeqLock.h"
+#include "RadarSweepClock.h"
+#include "RadarUnitCircle.h"
+
+class RadarTaskPool;
+
+// parameters that may be changed from a thread other than the render thread
+struct RadarParameters
+{
+    float sweepSpeed;
+    float detTolerance;
+};
 
 class RadarGeometry
 {
 public:
+    // distance between grid rings, ring r is drawn at radius r * RING_SPACING
+    static constexpr float RING_SPACING = 0.2f;
+
     RadarGeometry(float sweepSpeed = 60.0f, float sweepAngle = 0.0f, float tolerance = 5.0f)
+        : published(RadarParameters{sweepSpeed, tolerance}), clock(sweepSpeed, sweepAngle)
     {
         this->sweepSpeed = sweepSpeed;
         this->sweepAngle = sweepAngle;
@@ -22,21 +39,85 @@ public:
         this->sweepColor = sweepColor;
     }
 
+    // safe from any thread, picked up by the render thread on its next advanceSweep
     void update(float speed, float angle, float tolerance)
     {
-        sweepSpeed = speed;
-        sweepAngle += angle;
-        detTolerance = tolerance;
+        RadarParameters old = published.load();
+        published.store(RadarParameters{speed, tolerance});
+
+        if (speed != old.sweepSpeed)
+            clock.setSpeed(speed);
+        if (angle != 0.0f)
+            clock.nudge(angle);
     }
 
+    // drives the sweep angle, azimuth reports for phase lock go here
+    RadarSweepClock &getClock() { return clock; }
+
+    // latest published parameters, safe from any thread
+    RadarParameters getParameters() const { return published.load(); }
+
+    // copy published parameters into the render-side state, never blocks;
+    // a torn read keeps the previous frame's values
+    void syncParameters();
+    uint32_t getParameterVersion() const { return appliedVersion; }
+
+    // render-side state, only valid on the thread that advances the sweep
     float getSweepAngle() const { return sweepAngle; }
+    float getSweepSpeed() const { return sweepSpeed; }
     float getTolerance() const { return detTolerance; }
+    // side of the tolerance wedge that reaches targets first, and the direction it moves
+    // (-1 towards decreasing angle for a positive speed, alternating in a sector
+    // scan), for RadarTargetStore::cross
+    float getLeadingEdge() const { return getSweepDirection() < 0 ? sweepAngle - detTolerance / 2.0f : sweepAngle + detTolerance / 2.0f; }
+    int getSweepDirection() const
+    {
+        if (hasSector() && sectorScan)
+            return scanDirection;
+        return sweepSpeed >= 0.0f ? -1 : 1;
+    }
+    Vec4 getGridColor() const { return gridColor; }
+    Vec4 getSweepColor() const { return sweepColor; }
+
+    // Restrict grid and sweep to the arc from start counter-clockwise to end
+    // (degrees, wrapping through 0); start == end restores the full circle.
+    // With scan set the sweep moves back and forth across the arc at the
+    // sweep speed instead of rotating. Render thread, like setColors.
+    void setSector(float start, float end, bool scan);
+    bool hasSector() const { return sectorWidth < 360.0f; }
+    float getSectorStart() const { return sectorStart; }
+    float getSectorWidth() const { return sectorWidth; }
+    // NDC bounding box of the sector including the centre, [-1, 1] for the full circle
+    void getSectorBounds(Vec2 &lo, Vec2 &hi) const;
+    // NDC bounding box of the wedge from start counter-clockwise over width
+    // degrees, including the centre
+    static void getWedgeBounds(float start, float width, Vec2 &lo, Vec2 &hi);
+
+    // snapshot parameters and move the sweep to the clock's current angle without building vertices;
+    // deltaTime only advances a Manual clock, a Monotonic clock reads the time itself
+    float advanceSweep(float deltaTime);
 
     std::vector<RadarVertex> generateGrid(int rings, int radials, int segment = 100);
+    // same bytes as generateGrid, ring segments and radials split across the
+    // pool (shared pool when null), each chunk writing its own slice
+    std::vector<RadarVertex> generateGridParallel(int rings, int radials, int segment = 100, RadarTaskPool *pool = nullptr);
+    // dispatches to generateRings<Segments> for the standard segment counts
+    // (64, 100, 128, 256, 360), generateRingsDynamic otherwise; within a
+    // sector, arcs with segments in proportion to its width
     std::vector<RadarVertex> generateRings(int rings, int segment = 100);
+    // trig from a compile-time table, same vertices as generateRingsDynamic
+    template <int Segments>
+    std::vector<RadarVertex> generateRings(int rings);
+    std::vector<RadarVertex> generateRingsDynamic(int rings, int segment);
+    // within a sector: radials inside it plus its two edges
     std::vector<RadarVertex> generateRadials(int radials, int segment = 100);
+    // vertices generateRings/generateRadials return with the current sector
+    int getRingVertexCount(int rings, int segment) const;
+    int getRadialVertexCount(int radials) const;
     std::vector<RadarVertex> generateSweep(float deltaTime, int segments = 100);
     std::vector<RadarVertex> generateStoppedSweep(float angle, int segments = 100);
+    // one point per detection, for GL_POINTS; azimuths/bins give the polar image size
+    std::vector<RadarVertex> generateDetections(const std::vector<RadarDetection> &detections, int azimuths, int bins);
 
 private:
     float sweepSpeed;
@@ -45,7 +126,54 @@ private:
     Vec4 gridColor;
     Vec4 sweepColor;
 
+    float sectorStart = 0.0f;
+    float sectorWidth = 360.0f;
+    bool sectorScan = false;
+    // sector scan position, analytic in clock time like the rotation:
+    // distance travelled is scanDistance + |speed| * (t - scanTime), folded over 2 * width
+    double scanTime = 0.0;
+    double scanDistance = 0.0;
+    int scanDirection = -1;
+
+    // sweep angle of the sector scan at clock time t
+    float scanAngle(double t);
+    std::vector<RadarVertex> generateSectorRings(int rings, int segment);
+    std::vector<RadarVertex> generateSectorSweep(int segments);
+    // arc segments of one sector ring for a full-circle segment count
+    int sectorSegments(int segment) const;
+
+    // generateGrid work items [begin, end): rings * (segment + 1) ring segments, then the
+    // radials; item k always lands at the same offset of the output
+    void writeGrid(RadarVertex *out, int rings, int radials, int segment, size_t begin, size_t end) const;
+
+    RadarSeqLock<RadarParameters> published;
+    uint32_t appliedVersion = 0;
+    RadarSweepClock clock;
+
     const float PI = 3.14159265358979323846f;
 };
 
+template <int Segments>
+std::vector<RadarVertex> RadarGeometry::generateRings(int rings)
+{
+    const RadarUnitCircle<Segments> &circle = radarUnitCircle<Segments>;
+    std::vector<RadarVertex> result(rings > 0 ? (size_t)rings * Segments * 2 : 0);
+    RadarVertex *out = result.data();
+
+    for (int r = 1; r <= rings; r++)
+    {
+        float rad = r * RING_SPACING;
+        for (int i = 0; i < Segments; i++)
+        {
+            out[0].position = Vec2(rad * circle.cos[i], rad * circle.sin[i]);
+            out[0].color = gridColor;
+            out[1].position = Vec2(rad * circle.cos[i + 1], rad * circle.sin[i + 1]);
+            out[1].color = gridColor;
+            out += 2;
+        }
+    }
+
+    return result;
+}
+
 #endif
\ No newline at end of file
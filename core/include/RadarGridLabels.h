@@ -0,0 +1,55 @@
+#ifndef RadarGridLabels_H
+#define RadarGridLabels_H
+
+#include <vector>
+#include "RadarTypes.h"
+
+// Range-ring and bearing labels for the grid, as GL_LINES vertices in NDC so
+// they can be appended to the grid's own vertex buffer and drawn with it.
+// Text keeps a fixed pixel size, so the layout depends on the scope size;
+// sizes are rounded to zoom buckets (quarter octaves) and the vertices are
+// only laid out again when rings, radials, range, color or the bucket change.
+class RadarGridLabels
+{
+public:
+    // range is the value printed at the unit circle, rings show their share of it
+    explicit RadarGridLabels(float range = 1.0f) : range(range) {}
+
+    void setRange(float range) { this->range = range; }
+    float getRange() const { return range; }
+
+    // quarter-octave bucket of a size in pixels
+    static int zoomBucket(int pixels);
+
+    // true when build() would return the cached vertices unchanged
+    bool isCurrent(int rings, int radials, int width, int height, const Vec4 &color,
+                   float sectorStart = 0.0f, float sectorWidth = 360.0f) const;
+    // labels for the grid generated by RadarGeometry with the same rings, radials
+    // and sector; bearings outside the sector are left out
+    const std::vector<RadarVertex> &build(int rings, int radials, int width, int height, const Vec4 &color,
+                                          float sectorStart = 0.0f, float sectorWidth = 360.0f);
+    const std::vector<RadarVertex> &getVertices() const { return vertices; }
+
+private:
+    struct Key
+    {
+        int rings = -1;
+        int radials = -1;
+        int bucketW = 0;
+        int bucketH = 0;
+        float range = 0.0f;
+        float sectorStart = 0.0f;
+        float sectorWidth = 0.0f;
+        Vec4 color;
+    };
+
+    float range;
+    Key key;
+    std::vector<RadarVertex> vertices;
+
+    Key makeKey(int rings, int radials, int width, int height, const Vec4 &color, float sectorStart, float sectorWidth) const;
+    // text centred on an NDC anchor, offset by (dx, dy) pixels (y up)
+    void addText(const char *text, Vec2 anchor, float dx, float dy, float pxW, float pxH, const Vec4 &color);
+};
+
+#endif
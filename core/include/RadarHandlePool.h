@@ -0,0 +1,127 @@
+#ifndef RadarHandlePool_H
+#define RadarHandlePool_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <utility>
+
+// Objects constructed in place in pooled, cache-line aligned slots and
+// referred to by 32-bit handles: slot index in the low 16 bits, the slot's
+// generation in the high 16. A slot's generation is odd while it is live and
+// bumped on every allocate and release, so a handle to a released or reused
+// slot no longer matches and get() returns null. 0 is never a valid handle.
+// Slots are allocated in chunks that are never moved or freed before the
+// pool, so objects keep their address and get() takes no lock.
+template <typename T, size_t ChunkSize = 64>
+class RadarHandlePool
+{
+public:
+    static constexpr uint32_t MAX_OBJECTS = 1u << 16;
+
+    RadarHandlePool()
+    {
+        for (auto &chunk : chunks)
+            chunk.store(nullptr, std::memory_order_relaxed);
+    }
+
+    ~RadarHandlePool()
+    {
+        for (uint32_t i = 0; i < slotCount; i++)
+        {
+            Slot &slot = slotAt(i);
+            if (slot.generation.load(std::memory_order_relaxed) & 1)
+                slot.object()->~T();
+        }
+        for (auto &chunk : chunks)
+            delete[] chunk.load(std::memory_order_relaxed);
+    }
+
+    RadarHandlePool(const RadarHandlePool &) = delete;
+    RadarHandlePool &operator=(const RadarHandlePool &) = delete;
+
+    // constructs a T from args, returns 0 when the pool is full
+    template <typename... Args>
+    uint32_t allocate(Args &&...args)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        uint32_t index;
+        if (freeHead != NONE)
+        {
+            index = freeHead;
+            freeHead = slotAt(index).nextFree;
+        }
+        else
+        {
+            if (slotCount == MAX_OBJECTS)
+                return 0;
+            index = slotCount;
+            if (index % ChunkSize == 0)
+                chunks[index / ChunkSize].store(new Slot[ChunkSize], std::memory_order_release);
+            slotCount++;
+        }
+
+        Slot &slot = slotAt(index);
+        new (slot.storage) T(std::forward<Args>(args)...);
+        uint32_t generation = (slot.generation.load(std::memory_order_relaxed) + 1) & 0xFFFF;
+        slot.generation.store(generation, std::memory_order_release);
+        return (generation << 16) | index;
+    }
+
+    // destroys the object, returns false for a stale or invalid handle
+    bool release(uint32_t handle)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        T *object = get(handle);
+        if (!object)
+            return false;
+
+        uint32_t index = handle & 0xFFFF;
+        Slot &slot = slotAt(index);
+        slot.generation.store(((handle >> 16) + 1) & 0xFFFF, std::memory_order_release);
+        object->~T();
+        slot.nextFree = freeHead;
+        freeHead = index;
+        return true;
+    }
+
+    // null unless the handle refers to a live object
+    T *get(uint32_t handle) const
+    {
+        uint32_t index = handle & 0xFFFF;
+        Slot *chunk = chunks[index / ChunkSize].load(std::memory_order_acquire);
+        if (!chunk)
+            return nullptr;
+
+        Slot &slot = chunk[index % ChunkSize];
+        uint32_t generation = handle >> 16;
+        if (!(generation & 1) || slot.generation.load(std::memory_order_acquire) != generation)
+            return nullptr;
+        return slot.object();
+    }
+
+private:
+    static constexpr uint32_t NONE = ~0u;
+
+    struct alignas(64) Slot
+    {
+        alignas(T) unsigned char storage[sizeof(T)];
+        std::atomic<uint32_t> generation{0};
+        uint32_t nextFree = NONE;
+
+        T *object() { return std::launder(reinterpret_cast<T *>(storage)); }
+    };
+
+    Slot &slotAt(uint32_t index) const { return chunks[index / ChunkSize].load(std::memory_order_relaxed)[index % ChunkSize]; }
+
+    std::atomic<Slot *> chunks[MAX_OBJECTS / ChunkSize];
+    std::mutex mutex;
+    uint32_t freeHead = NONE;
+    uint32_t slotCount = 0;
+};
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef RadarLatencyTracker_H
+#define RadarLatencyTracker_H
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+// pipeline stages a spoke's latency is split into
+enum RadarLatencyStage
+{
+    RADAR_LATENCY_DECODE = 0,  // packet received -> decoded into the polar image
+    RADAR_LATENCY_UPLOAD = 1,  // decoded -> uploaded to the video texture
+    RADAR_LATENCY_PRESENT = 2, // uploaded -> frame finished on the GPU after the swap
+    RADAR_LATENCY_TOTAL = 3,   // received -> presented, the age of what is on screen
+    RADAR_LATENCY_STAGES = 4
+};
+
+// Log-scale latency histogram, a quarter octave per bucket from 1 us up to
+// about a minute. Lock-free, so the receive and render threads record into
+// it while any thread reads it.
+class RadarLatencyHistogram
+{
+public:
+    static const int BUCKETS = 104;
+
+    struct Summary
+    {
+        uint64_t count;
+        double meanMs, p50Ms, p95Ms, p99Ms, maxMs;
+    };
+
+    RadarLatencyHistogram() { reset(); }
+
+    void add(int64_t nanos);
+    void reset();
+
+    uint64_t getCount() const { return count.load(std::memory_order_relaxed); }
+    uint64_t getBucket(int bucket) const { return buckets[bucket].load(std::memory_order_relaxed); }
+    // upper edge of a bucket in milliseconds
+    static double bucketUpperMs(int bucket);
+    // percentiles are bucket upper edges, within a quarter octave of the sample
+    Summary summarize() const;
+
+private:
+    std::atomic<uint64_t> buckets[BUCKETS];
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> sumNanos;
+    std::atomic<int64_t> maxNanos;
+};
+
+// Per-stage latency of the video path. Spokes are timestamped on receive
+// and decode (wall clock, the clock of the listener's kernel timestamps);
+// the render thread collects the spokes it uploads into a Frame and hands
+// it over once the frame is known to be presented.
+class RadarLatencyTracker
+{
+public:
+    // spokes uploaded in one frame, waiting for the frame to be presented
+    struct Frame
+    {
+        int64_t uploadTime = 0;
+        std::vector<int64_t> receiveTimes;
+    };
+
+    static RadarLatencyTracker &shared();
+    // wall clock nanoseconds since the Unix epoch
+    static int64_t now();
+
+    void record(RadarLatencyStage stage, int64_t nanos) { stages[stage].add(nanos); }
+    // decoded spoke, received at receiveTime
+    void decoded(int64_t receiveTime, int64_t decodeTime) { record(RADAR_LATENCY_DECODE, decodeTime - receiveTime); }
+    // upload -> present once for the frame, receive -> present for each of its spokes
+    void presented(const Frame &frame, int64_t presentTime);
+
+    const RadarLatencyHistogram &getStage(RadarLatencyStage stage) const { return stages[stage]; }
+    void reset();
+
+private:
+    RadarLatencyHistogram stages[RADAR_LATENCY_STAGES];
+};
+
+#endif
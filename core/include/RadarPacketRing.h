@@ -0,0 +1,60 @@
+#ifndef RadarPacketRing_H
+#define RadarPacketRing_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Bounded lock-free single-producer / single-consumer queue of variable-size
+// packets, copied into one contiguous byte ring. A packet never wraps: one
+// that does not fit before the end of the buffer starts over at the front.
+// push drops (and counts) packets when the ring is full instead of blocking
+// the receive thread.
+class RadarPacketRing
+{
+public:
+    // capacity is rounded up to a power of two
+    explicit RadarPacketRing(size_t capacity = 1 << 20);
+
+    RadarPacketRing(const RadarPacketRing &) = delete;
+    RadarPacketRing &operator=(const RadarPacketRing &) = delete;
+
+    // producer side only
+    bool push(const void *data, size_t size, int64_t timestamp);
+
+    // consumer side only; front returns nullptr when empty, the packet stays
+    // valid until pop
+    const uint8_t *front(size_t &size, int64_t &timestamp);
+    void pop();
+    bool pop(std::string &out, int64_t *timestamp = nullptr);
+
+    size_t getCapacity() const { return buffer.size(); }
+    // largest packet push accepts
+    size_t getMaxPacket() const { return buffer.size() / 2 - sizeof(Record); }
+    uint64_t getDropped() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    struct Record
+    {
+        uint32_t size; // WRAP: skip to the front of the buffer
+        uint32_t reserved;
+        int64_t timestamp;
+    };
+    static const uint32_t WRAP = 0xFFFFFFFFu;
+    static const size_t ALIGN = sizeof(Record);
+
+    std::vector<uint8_t> buffer;
+    size_t mask;
+
+    // byte positions, only ever increase; index = position & mask
+    alignas(64) std::atomic<size_t> head{0};
+    size_t cachedTail = 0; // producer's last view of tail
+    alignas(64) std::atomic<size_t> tail{0};
+    size_t cachedHead = 0; // consumer's last view of head
+    size_t frontSize = 0;  // bytes the front packet takes, set by front
+    alignas(64) std::atomic<uint64_t> dropped{0};
+};
+
+#endif
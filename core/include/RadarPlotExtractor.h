@@ -0,0 +1,73 @@
+#ifndef RadarPlotExtractor_H
+#define RadarPlotExtractor_H
+
+#include <cstdint>
+#include <vector>
+#include "RadarTypes.h"
+
+// Streaming plot extraction from thresholded polar video.
+// Spokes are fed in rotation order; runs of non-zero cells along range are
+// connected to overlapping runs of the previous spoke with a union-find over
+// live clusters only, so memory stays O(bins) no matter how many spokes a
+// revolution has. A plot is emitted as soon as a spoke no longer touches it.
+// All state lives in flat arrays that are reused, nothing is allocated per hit.
+class RadarPlotExtractor
+{
+public:
+    struct Config
+    {
+        int azimuths = 4096; // spokes per revolution, for converting to degrees
+        int rangeGap = 1;    // empty bins allowed between cells of one plot
+        int minCells = 2;    // smaller clusters are dropped as noise
+    };
+
+    explicit RadarPlotExtractor(const Config &config);
+
+    // next spoke in rotation order; `azimuth` is its row, closed plots are appended
+    void addSpoke(int azimuth, const uint8_t *video, int bins, std::vector<RadarPlot> &plots);
+    // close every open cluster, at the end of data
+    void flush(std::vector<RadarPlot> &plots);
+    void reset();
+
+    int getOpenCount() const { return (int)active.size(); }
+
+private:
+    struct Run
+    {
+        int start;
+        int end; // inclusive
+        int label;
+    };
+
+    struct Cluster
+    {
+        int parent;
+        uint32_t stamp; // last spoke that touched it
+        int cells;
+        int peak;
+        int rangeStart;
+        int rangeEnd;
+        int64_t azimuthStart; // unwrapped spoke index
+        int64_t azimuthEnd;
+        double amplitude;
+        double azimuthMoment;
+        double rangeMoment;
+    };
+
+    Config config;
+    std::vector<Run> previous, current;
+    std::vector<Cluster> clusters;
+    std::vector<int> freeList;
+    std::vector<int> active; // clusters allocated since they were last checked
+    uint32_t spokeCount = 0;
+    int lastAzimuth = -1;
+    int64_t unwrapped = 0; // continuous azimuth across north
+
+    int allocate();
+    int find(int c);
+    void merge(int a, int b);
+    void emit(const Cluster &c, std::vector<RadarPlot> &plots) const;
+    void closeUntouched(std::vector<RadarPlot> &plots, bool all);
+};
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef RadarPolarImage_H
+#define RadarPolarImage_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// One revolution of radar video in polar layout: a row of range bins per
+// azimuth step. Each row carries a version so consumers (texture upload,
+// history reconstruction) can tell which rows changed.
+struct RadarPolarImage
+{
+    int azimuths = 0;
+    int bins = 0;
+    std::vector<uint8_t> data;
+    std::vector<uint64_t> rowVersion;
+
+    RadarPolarImage() {}
+    RadarPolarImage(int azimuths, int bins) { resize(azimuths, bins); }
+
+    void resize(int azimuths, int bins)
+    {
+        this->azimuths = azimuths;
+        this->bins = bins;
+        data.assign((size_t)azimuths * bins, 0);
+        rowVersion.assign(azimuths, 0);
+    }
+
+    uint8_t *row(int azimuth) { return data.data() + (size_t)azimuth * bins; }
+    const uint8_t *row(int azimuth) const { return data.data() + (size_t)azimuth * bins; }
+
+    // azimuth row for an angle in degrees (RadarGeometry sweep convention)
+    int rowFor(float degrees) const
+    {
+        int index = (int)(degrees * azimuths / 360.0f) % azimuths;
+        return index < 0 ? index + azimuths : index;
+    }
+
+    // rows crossed by a sweep moving between two angles, the shorter way
+    // round, both end rows included; first + count may run past the last
+    // row and continue at row 0
+    void sweptRows(float fromDegrees, float toDegrees, int &first, int &count) const
+    {
+        first = count = 0;
+        if (azimuths == 0)
+            return;
+
+        float delta = std::fmod(toDegrees - fromDegrees, 360.0f);
+        if (delta < 0.0f)
+            delta += 360.0f;
+        float start = delta <= 180.0f ? fromDegrees : toDegrees;
+        float width = delta <= 180.0f ? delta : 360.0f - delta;
+
+        first = rowFor(start);
+        int last = rowFor(start + width);
+        count = (last - first + azimuths) % azimuths + 1;
+    }
+};
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef RadarPolarPyramid_H
+#define RadarPolarPyramid_H
+
+#include <cstdint>
+#include <vector>
+#include "RadarPolarImage.h"
+
+// Max-preserving reductions of a polar image for zoomed-out views. Level 0
+// is the image itself; every further level halves the range bins, and the
+// azimuths as long as an azimuth step at the edge stays no wider than a
+// range bin. A cell holds the maximum of the cells it covers, so a one-bin
+// target survives at every level instead of being averaged or skipped.
+// Rows are updated incrementally as spokes arrive (SSE2 where available,
+// with a bit-identical scalar fallback).
+class RadarPolarPyramid
+{
+public:
+    // levels below the image, the smallest keeps at least minBins range bins
+    explicit RadarPolarPyramid(int maxLevels = 5, int minBins = 64);
+
+    // reduce every row of the image, (re)allocating levels for its size
+    void build(const RadarPolarImage &image);
+    // reduce one changed image row through all levels, builds on a size change
+    void updateRow(const RadarPolarImage &image, int azimuth);
+
+    // levels below the image, 0 before build()
+    int getLevelCount() const { return (int)levels.size(); }
+    // level 1..getLevelCount()
+    const RadarPolarImage &getLevel(int level) const { return levels[level - 1]; }
+    // row of a level holding image row `azimuth`
+    int levelRow(int level, int azimuth) const { return azimuth >> azimuthShift[level]; }
+
+    // finest level whose cells are at least a pixel wide in range, for the
+    // image drawn `pixels` pixels from centre to edge
+    int chooseLevel(float pixels) const { return chooseLevel(pixels, baseBins, getLevelCount()); }
+    // same for an image of `bins` range bins with `levelCount` levels below it
+    static int chooseLevel(float pixels, int bins, int levelCount);
+
+    // out[i] = max of a[2i], a[2i + 1], b[2i], b[2i + 1] for (bins + 1) / 2
+    // outputs, the last pair clipped for odd bins; b may equal a
+    static void reduceRows(const uint8_t *a, const uint8_t *b, uint8_t *out, int bins);
+
+private:
+    int maxLevels;
+    int minBins;
+    int baseAzimuths = 0;
+    int baseBins = 0;
+    std::vector<RadarPolarImage> levels;
+    // per level, how far image rows shift down to that level's rows (0 at level 0)
+    std::vector<int> azimuthShift;
+
+    // reduce row `row` of `level` from the level above it (the image for level 1)
+    void reduceRow(const RadarPolarImage &image, int level, int row);
+};
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef RadarRecorder_H
+#define RadarRecorder_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "RadarRecording.h"
+
+// Appends raw packets to a segmented recording file (see RadarRecording.h).
+// Not thread-safe, meant to be driven by the thread that receives the packets.
+class RadarRecorder
+{
+public:
+    // segmentBytes: record bytes after which the segment is closed and indexed
+    RadarRecorder(uint64_t segmentBytes = 64ull << 20);
+    ~RadarRecorder();
+
+    bool open(const std::string &path);
+    void close();
+    bool isOpen() const { return file != nullptr; }
+
+    // timestamp in nanoseconds since the Unix epoch, usually the kernel receive time
+    bool write(const void *data, uint32_t size, int64_t timestamp);
+
+    // close the current segment so everything written so far is indexed on disk
+    void flush();
+
+    uint64_t getPacketCount() const { return packetCount; }
+
+private:
+    FILE *file = nullptr;
+    std::vector<char> fileBuffer;
+    uint64_t segmentBytes;
+    uint64_t offset = 0;
+    uint64_t segmentStart = 0;
+    uint64_t packetCount = 0;
+    std::vector<RadarIndexEntry> index; // current segment, reused between segments
+
+    void closeSegment();
+};
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef RadarRecording_H
+#define RadarRecording_H
+
+#include <cstdint>
+
+// On-disk layout of a radar session recording (little-endian, 8-byte aligned).
+//
+// file:    RadarFileHeader, then segments back to back
+// segment: records, then `count` RadarIndexEntry, then RadarSegmentTrailer
+// record:  RadarRecordHeader, payload, zero padding to 8 bytes
+//
+// The file is append-only: a segment's index is written once the segment is
+// closed, and trailers point back to the segment start, so a reader walks the
+// segments from the end of the file. Records after the last trailer (a crash
+// mid-segment) are still recoverable by scanning their headers.
+
+const uint32_t RADAR_REC_FILE_MAGIC = 0x4C465252;    // "RRFL"
+const uint32_t RADAR_REC_RECORD_MAGIC = 0x43455252;  // "RREC"
+const uint32_t RADAR_REC_TRAILER_MAGIC = 0x58495252; // "RRIX"
+const uint32_t RADAR_REC_VERSION = 1;
+
+struct RadarFileHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t reserved;
+};
+
+struct RadarRecordHeader
+{
+    uint32_t magic;
+    uint32_t size;     // payload bytes, excluding padding
+    int64_t timestamp; // receive time, nanoseconds since the Unix epoch
+};
+
+struct RadarIndexEntry
+{
+    int64_t timestamp;
+    uint64_t offset; // file offset of the RadarRecordHeader
+    float azimuth;   // degrees, negative when the packet is not a spoke
+    uint32_t size;
+};
+
+struct RadarSegmentTrailer
+{
+    uint32_t magic;
+    uint32_t count;        // records (and index entries) in the segment
+    uint64_t segmentStart; // file offset of the first record
+    uint64_t indexOffset;  // file offset of the first index entry
+    int64_t firstTimestamp;
+    int64_t lastTimestamp;
+};
+
+static_assert(sizeof(RadarRecordHeader) % 8 == 0 && sizeof(RadarIndexEntry) % 8 == 0 &&
+                  sizeof(RadarSegmentTrailer) % 8 == 0 && sizeof(RadarFileHeader) % 8 == 0,
+              "recording structures must keep 8-byte alignment");
+
+inline uint64_t radarRecordPadded(uint64_t size) { return (size + 7) & ~uint64_t(7); }
+
+// one packet as seen by replay, points straight into the mapped file
+struct RadarPacketView
+{
+    const uint8_t *data;
+    uint32_t size;
+    int64_t timestamp;
+    float azimuth;
+};
+
+#endif
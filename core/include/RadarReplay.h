@@ -0,0 +1,67 @@
+#ifndef RadarReplay_H
+#define RadarReplay_H
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+#include "RadarRecording.h"
+
+// Memory-maps a recording and plays it back. Packets are handed out as views
+// into the mapping, so replay itself never allocates per packet.
+class RadarReplay
+{
+public:
+    RadarReplay();
+    ~RadarReplay();
+
+    bool open(const std::string &path);
+    void close();
+
+    uint64_t getPacketCount() const { return packetCount; }
+    int64_t getFirstTimestamp() const;
+    int64_t getLastTimestamp() const;
+
+    // position on the first packet at or after timestamp, O(log n) through the segment indexes
+    void seek(int64_t timestamp);
+    void rewind() { segment = 0; entry = 0; }
+
+    // pull interface, false at the end of the recording
+    bool next(RadarPacketView &packet);
+
+    // push packets to sink paced by their timestamps: speed 1 is real time,
+    // N is N times faster, 0 is as fast as possible. Returns packets delivered.
+    uint64_t play(const std::function<void(const RadarPacketView &)> &sink, double speed = 1.0);
+    // ends play, also one that has not started yet; open clears it
+    void stop() { stopRequested = true; }
+
+private:
+    struct Segment
+    {
+        const RadarIndexEntry *entries;
+        uint32_t count;
+        int64_t firstTimestamp;
+        int64_t lastTimestamp;
+    };
+
+    const uint8_t *base = nullptr;
+    size_t size = 0;
+    void *fileHandle = nullptr; // platform handles, only used on Windows
+    void *mappingHandle = nullptr;
+
+    std::vector<Segment> segments;
+    std::vector<RadarIndexEntry> recoveredIndex; // tail written without a trailer
+    uint64_t packetCount = 0;
+
+    size_t segment = 0;
+    size_t entry = 0;
+    std::atomic<bool> stopRequested{false};
+
+    bool map(const std::string &path);
+    void unmap();
+    uint64_t loadSegments();
+    void recoverTail(uint64_t start);
+};
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef RadarScanConverter_H
+#define RadarScanConverter_H
+
+#include <cstdint>
+#include <vector>
+#include "RadarPolarImage.h"
+#include "RadarPolarPyramid.h"
+
+// Scan conversion on the CPU for exports and consumers without GL: polar
+// video resampled to an 8-bit Cartesian image with the same mapping as the
+// video shader (nearest cell, angle from +x towards +y, the unit circle
+// filling the image). With a pyramid the level is picked from the pixels
+// per range bin like the GPU path, so zoomed-out output keeps small targets.
+// The pixel to cell table is cached per output size and level.
+class RadarScanConverter
+{
+public:
+    // width x height pixels, row 0 at the top; pyramid may be null
+    void convert(const RadarPolarImage &image, const RadarPolarPyramid *pyramid, int width, int height, uint8_t *out);
+    // level used by the last convert, 0 for the image itself
+    int getLevel() const { return level; }
+
+private:
+    static constexpr uint32_t OUTSIDE = ~0u;
+
+    int width = 0;
+    int height = 0;
+    int azimuths = 0;
+    int bins = 0;
+    int level = 0;
+    std::vector<uint32_t> cells; // cell index per pixel, OUTSIDE beyond the edge
+
+    void buildTable(int width, int height, int azimuths, int bins);
+};
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef RadarSceneGenerator_H
+#define RadarSceneGenerator_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "RadarSpoke.h"
+
+// Synthetic radar video for load and end-to-end tests: a rotating antenna
+// over receiver noise, fixed land clutter, sea clutter and moving targets,
+// emitted as wire-format spokes (RadarSpoke.h). A spoke's content depends
+// only on the config (seed included) and its sequence number, so runs are
+// reproducible across machines: the random numbers come from a counter
+// based hash, not from <random>, whose distributions differ between
+// standard libraries.
+class RadarSceneGenerator
+{
+public:
+    struct Config
+    {
+        uint64_t seed = 1;
+        uint16_t radarId = 0;
+        int spokesPerRevolution = 4096;
+        int bins = 2048;
+        float rpm = 24.0f;
+        RadarSpokeEncoding encoding = RADAR_SPOKE_PACKBITS;
+
+        float noise = 12.0f;  // mean receiver noise amplitude
+        float clutter = 0.5f; // fraction of land patches at full strength, 0 for none
+        int seaState = 3;     // Douglas sea state 0..9, sea clutter near the radar
+        int targets = 20;
+        float maxSpeed = 0.02f; // target speed limit, ranges per second
+    };
+
+    explicit RadarSceneGenerator(const Config &config);
+
+    const Config &getConfig() const { return config; }
+    // seconds between spokes at the configured rotation rate
+    double getSpokeInterval() const { return 60.0 / (config.rpm * config.spokesPerRevolution); }
+    // largest packet spoke() can produce
+    size_t maxPacketSize() const;
+
+    // spoke `sequence` of the scene at sequence * getSpokeInterval() seconds:
+    // header and payload written to packet (maxPacketSize() bytes), returns
+    // the packet size. timestamp goes into the header as the sender time.
+    size_t spoke(uint32_t sequence, int64_t timestamp, uint8_t *packet);
+
+    // amplitudes of spoke `sequence` without the wire format, bins cells
+    void amplitudes(uint32_t sequence, uint8_t *cells);
+
+private:
+    struct Target
+    {
+        float x, y;   // start position, ranges (1 is the last bin)
+        float vx, vy; // ranges per second
+        float size;   // radial extent in bins
+        float strength;
+    };
+
+    Config config;
+    std::vector<Target> targets;
+    std::vector<uint8_t> landMask; // clutter strength per coarse cell, 0 for none
+    std::vector<float> seaProfile; // mean sea clutter per bin
+    std::vector<uint8_t> cells;    // amplitudes of the last generated spoke
+
+    static const int LAND_AZIMUTHS = 256;
+    static const int LAND_BINS = 128;
+
+    // azimuth step (0..spokesPerRevolution - 1) of a spoke
+    int azimuthStep(uint32_t sequence) const;
+    // amplitudes of a spoke into cells
+    void generate(uint32_t sequence);
+};
+
+#endif
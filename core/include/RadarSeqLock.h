@@ -0,0 +1,85 @@
+#ifndef RadarSeqLock_H
+#define RadarSeqLock_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Sequence lock around a small trivially copyable block.
+// Writers (any thread) serialize on the sequence counter; readers never block:
+// tryLoad makes a single attempt and reports a torn read instead of retrying,
+// so a render thread can keep its previous snapshot and stay wait-free.
+template <typename T>
+class RadarSeqLock
+{
+    static_assert(std::is_trivially_copyable<T>::value, "RadarSeqLock needs a trivially copyable type");
+
+public:
+    explicit RadarSeqLock(const T &initial = T())
+    {
+        uint32_t tmp[WORDS] = {};
+        memcpy(tmp, &initial, sizeof(T));
+        for (size_t i = 0; i < WORDS; i++)
+            words[i].store(tmp[i], std::memory_order_relaxed);
+    }
+
+    void store(const T &value)
+    {
+        uint32_t seq = sequence.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            if (!(seq & 1) && sequence.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire))
+                break;
+            seq = sequence.load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+
+        uint32_t tmp[WORDS] = {};
+        memcpy(tmp, &value, sizeof(T));
+        for (size_t i = 0; i < WORDS; i++)
+            words[i].store(tmp[i], std::memory_order_relaxed);
+
+        sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    // single attempt, returns false if a writer was active
+    bool tryLoad(T &out) const
+    {
+        uint32_t seq = sequence.load(std::memory_order_acquire);
+        if (seq & 1)
+            return false;
+
+        uint32_t tmp[WORDS];
+        for (size_t i = 0; i < WORDS; i++)
+            tmp[i] = words[i].load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence.load(std::memory_order_relaxed) != seq)
+            return false;
+
+        memcpy(&out, tmp, sizeof(T));
+        return true;
+    }
+
+    // retrying read for threads that may wait (UI side)
+    T load() const
+    {
+        T out;
+        while (!tryLoad(out))
+        {
+        }
+        return out;
+    }
+
+    // even values only change when a store completed
+    uint32_t version() const { return sequence.load(std::memory_order_acquire); }
+
+private:
+    static constexpr size_t WORDS = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+    std::atomic<uint32_t> sequence{0};
+    std::atomic<uint32_t> words[WORDS];
+};
+
+#endif
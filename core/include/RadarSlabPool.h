@@ -0,0 +1,50 @@
+#ifndef RadarSlabPool_H
+#define RadarSlabPool_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Pooled allocator for many small variable-size blobs (encoded spokes).
+// Blocks come in power-of-two size classes carved out of large slabs, freed
+// blocks go to a per-class free list and slabs are kept for reuse, so the
+// steady state does no heap allocation at all.
+class RadarSlabPool
+{
+public:
+    explicit RadarSlabPool(size_t slabSize = 1 << 20);
+    ~RadarSlabPool();
+
+    RadarSlabPool(const RadarSlabPool &) = delete;
+    RadarSlabPool &operator=(const RadarSlabPool &) = delete;
+
+    // nullptr if size exceeds the largest class
+    uint8_t *allocate(size_t size);
+    void release(uint8_t *block, size_t size);
+
+    // bytes handed out (rounded up to the class size)
+    size_t getBytesInUse() const { return bytesInUse; }
+    size_t getBytesReserved() const { return slabs.size() * slabSize; }
+
+    static const size_t MIN_BLOCK = 16;
+    static const size_t MAX_BLOCK = 64 * 1024;
+
+private:
+    static const int CLASS_COUNT = 13; // 16 B .. 64 KiB
+
+    struct FreeBlock
+    {
+        FreeBlock *next;
+    };
+
+    size_t slabSize;
+    std::vector<uint8_t *> slabs;
+    FreeBlock *freeLists[CLASS_COUNT] = {};
+    uint8_t *cursor = nullptr; // bump pointer in the newest slab
+    size_t remaining = 0;
+    size_t bytesInUse = 0;
+
+    static int classOf(size_t size);
+};
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef RadarSpoke_H
+#define RadarSpoke_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Wire format of one radar video spoke (little-endian):
+// a fixed header followed by `bins` range cells of 8-bit amplitude,
+// raw or PackBits coded (RadarSpokeCodec).
+// Azimuth uses the same convention as RadarGeometry's sweep angle,
+// scaled so 65536 is one full turn.
+
+const uint32_t RADAR_SPOKE_MAGIC = 0x4B505352; // "RSPK"
+const uint16_t RADAR_SPOKE_VERSION = 1;
+
+enum RadarSpokeEncoding : uint16_t
+{
+    RADAR_SPOKE_RAW8 = 0,
+    RADAR_SPOKE_PACKBITS = 1
+};
+
+#pragma pack(push, 1)
+struct RadarSpokeHeader
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t radarId;
+    uint32_t sequence;
+    uint16_t azimuth;
+    uint16_t bins;
+    uint16_t encoding;
+    uint16_t payloadSize; // bytes following the header
+    int64_t timestamp;    // sender time, nanoseconds
+};
+#pragma pack(pop)
+
+inline float radarAzimuthToDegrees(uint16_t azimuth) { return azimuth * (360.0f / 65536.0f); }
+inline uint16_t radarDegreesToAzimuth(float degrees) { return (uint16_t)(int64_t)(degrees * (65536.0f / 360.0f)); }
+
+// validates the header, returns the payload or nullptr if the packet is not a spoke
+inline const uint8_t *radarParseSpoke(const void *data, size_t size, RadarSpokeHeader &header)
+{
+    if (size < sizeof(RadarSpokeHeader))
+        return nullptr;
+
+    memcpy(&header, data, sizeof(RadarSpokeHeader));
+    if (header.magic != RADAR_SPOKE_MAGIC || header.version != RADAR_SPOKE_VERSION)
+        return nullptr;
+    if (sizeof(RadarSpokeHeader) + header.payloadSize > size)
+        return nullptr;
+
+    return static_cast<const uint8_t *>(data) + sizeof(RadarSpokeHeader);
+}
+
+#endif
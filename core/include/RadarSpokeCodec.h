@@ -0,0 +1,24 @@
+#ifndef RadarSpokeCodec_H
+#define RadarSpokeCodec_H
+
+#include <cstddef>
+#include <cstdint>
+
+// PackBits run-length coding of 8-bit spoke amplitudes. Radar video is mostly
+// noise floor and flat returns, which compresses well with plain runs.
+//   control n in [0, 127]:    n + 1 literal bytes follow
+//   control n in [129, 255]:  next byte repeated 257 - n times
+class RadarSpokeCodec
+{
+public:
+    // worst case output size for `bins` input bytes
+    static size_t maxEncodedSize(int bins) { return bins + (bins + 127) / 128; }
+
+    // out must hold maxEncodedSize(bins) bytes, returns bytes written
+    static size_t encode(const uint8_t *in, int bins, uint8_t *out);
+
+    // returns the number of bins written, stops at `bins` or on malformed input
+    static int decode(const uint8_t *in, size_t size, uint8_t *out, int bins);
+};
+
+#endif
@@ -0,0 +1,120 @@
+#ifndef RadarSpokeHistory_H
+#define RadarSpokeHistory_H
+
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "RadarPolarImage.h"
+#include "RadarSlabPool.h"
+
+class RadarTaskPool;
+
+// Compressed in-memory history of received spokes for time scrubbing.
+// Spokes are PackBits coded into a slab pool and grouped into one chunk per
+// revolution. When the history exceeds the memory budget the least
+// recently used revolutions are moved to a spill file and read back on
+// demand; revolutions older than the retention window are dropped. The
+// spill file is written and read outside the history's lock, so a slow
+// disk never holds up addSpoke or another reconstruct.
+class RadarSpokeHistory
+{
+public:
+    struct Config
+    {
+        int azimuths = 2048;             // spokes per revolution
+        int bins = 1024;                 // range cells per spoke
+        double retentionSeconds = 600.0; // how far back scrubbing can go
+        // coded spokes plus the per-revolution spoke index (azimuths * 32
+        // bytes a turn), which stays in memory while a turn is spilled
+        size_t memoryBudget = 256u << 20;
+        std::string spillPath; // empty disables spilling, revolutions over budget are dropped instead
+    };
+
+    explicit RadarSpokeHistory(const Config &config, RadarTaskPool *pool = nullptr);
+    ~RadarSpokeHistory();
+
+    // receive thread; timestamp in nanoseconds, azimuth in degrees
+    void addSpoke(float azimuth, int64_t timestamp, const uint8_t *data, int bins);
+
+    // rebuild the polar image as it was displayed at `timestamp`: every azimuth
+    // shows its latest spoke at or before that time. Rows already holding the
+    // right spoke (image.rowVersion) are left alone, the rest decode in parallel.
+    // Returns false if the time is outside the stored history.
+    bool reconstruct(int64_t timestamp, RadarPolarImage &image);
+
+    int64_t getFirstTimestamp();
+    int64_t getLastTimestamp();
+    // start time of the revolution `back` turns before the newest one, for stepping
+    int64_t getRevolutionStart(int back);
+
+    size_t getMemoryInUse();
+    size_t getRevolutionCount();
+
+private:
+    struct Spoke
+    {
+        uint64_t id;         // unique, 0 for an empty slot
+        int64_t timestamp;
+        uint8_t *data;       // slab block, nullptr while spilled
+        uint32_t size;
+        uint32_t spillOffset; // offset in the revolution's spill extent
+    };
+
+    struct Revolution
+    {
+        int64_t start;
+        int64_t end;
+        std::vector<Spoke> spokes;
+        size_t bytes = 0;   // coded bytes of all spokes
+        bool spilled = false;
+        bool spilling = false; // being written out, still readable from memory
+        uint64_t spillOffset = 0;
+        uint64_t lastUse = 0;
+        // spill writes and reconstructs in progress; a pinned turn is neither
+        // dropped nor restored by anyone else, and a spill already under way
+        // keeps its spokes in memory if a reconstruct pinned it meanwhile, so
+        // spokes and spill extent stay put while the lock is released
+        int pins = 0;
+    };
+
+    struct Extent
+    {
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    Config config;
+    RadarTaskPool *pool;
+    RadarSlabPool slabs;
+    std::vector<uint8_t> encodeBuffer;
+
+    std::mutex mutex;
+    std::deque<Revolution> revolutions;
+    int lastAzimuth = -1;
+    uint64_t nextSpokeId = 1;
+    uint64_t useCounter = 0;
+
+    // the file itself, only used without mutex held
+    std::mutex fileMutex;
+    FILE *spill = nullptr;
+    // extents, under mutex
+    uint64_t spillEnd = 0;
+    std::vector<Extent> spillFree;
+    size_t pendingSpill = 0; // bytes of turns being written out
+
+    size_t memoryInUse() const;
+    void enforceLimits(int64_t now, const Revolution *keep, std::vector<Revolution *> &toSpill);
+    void dropRevolution(Revolution &rev);
+    // writes a turn claimed by enforceLimits, then frees its memory
+    void spillRevolution(Revolution &rev);
+    bool readSpill(uint64_t offset, uint64_t size, std::vector<uint8_t> &out);
+    void restoreRevolution(Revolution &rev, const std::vector<uint8_t> &extent);
+    uint64_t allocateSpill(uint64_t size);
+    void releaseSpill(uint64_t offset, uint64_t size);
+    int findRevolution(int64_t timestamp) const;
+};
+
+#endif
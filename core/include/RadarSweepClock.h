@@ -0,0 +1,68 @@
+#ifndef RadarSweepClock_H
+#define RadarSweepClock_H
+
+#include <atomic>
+#include <mutex>
+#include "RadarSeqLock.h"
+
+// Sweep angle as an analytic function of time instead of a per-frame
+// integration: angle(t) = anchorAngle - speed * (t - anchorTime).
+// The anchor is re-published when the speed changes or an azimuth report
+// arrives, so frame pacing never accumulates into angle error.
+class RadarSweepClock
+{
+public:
+    enum Source
+    {
+        Monotonic, // steady clock, deltaTime is ignored
+        Manual     // time only moves by advance(deltaTime), for offline/headless use
+    };
+
+    RadarSweepClock(float speed = 60.0f, float angle = 0.0f);
+
+    // producers, any thread
+    void setSpeed(float degPerSec);
+    void setAngle(float angle);
+    void nudge(float delta);
+    void reportAzimuth(float azimuth) { reportAzimuth(azimuth, now()); }
+    void reportAzimuth(float azimuth, double time);
+    void setPhaseLock(bool enabled);
+
+    void setSource(Source source);
+
+    // render thread
+    void advance(float deltaTime) { manualTime.store(manualTime.load(std::memory_order_relaxed) + deltaTime, std::memory_order_relaxed); }
+    bool sync();
+    float angle() const { return angleAt(currentTime()); }
+    float angleAt(double time) const;
+    double currentTime() const { return source.load(std::memory_order_relaxed) == Monotonic ? now() : manualTime.load(std::memory_order_relaxed); }
+
+    // seconds on the monotonic clock, used to timestamp reports
+    static double now();
+
+private:
+    struct Anchor
+    {
+        double angle;
+        double time;
+        double speed; // degrees per second, positive turns the sweep clockwise
+    };
+
+    RadarSeqLock<Anchor> published;
+    Anchor current;
+
+    std::atomic<int> source{Monotonic};
+    std::atomic<double> manualTime{0.0};
+
+    // producer side, guarded so concurrent setters don't lose updates
+    std::mutex writeMutex;
+    float nominalSpeed;
+    bool phaseLock = false;
+    bool haveReport = false;
+    double lastReportAngle = 0.0;
+    double lastReportTime = 0.0;
+
+    void publish(double angle, double time, double speed);
+};
+
+#endif
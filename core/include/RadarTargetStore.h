@@ -0,0 +1,61 @@
+#ifndef RadarTargetStore_H
+#define RadarTargetStore_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "RadarTypes.h"
+
+// Plots waiting to be revealed by the sweep, indexed by azimuth.
+// Each frame the caller passes the angles the sweep's leading edge moved
+// through since the previous frame; only the targets inside that interval
+// are found (binary search over the sorted index, wrapping at north) and
+// have their highlight timer restarted, so the per-frame cost is
+// O(log n + k) instead of a scan over every target.
+class RadarTargetStore
+{
+public:
+    struct Target
+    {
+        RadarPlot plot;
+        double refreshTime; // last time the beam crossed it, negative if never
+        bool used;
+    };
+
+    explicit RadarTargetStore(double fadeSeconds = 3.0) : fadeSeconds(fadeSeconds) {}
+
+    uint32_t add(const RadarPlot &plot);
+    // new position for a tracked target, shown when the beam next crosses it
+    void update(uint32_t id, const RadarPlot &plot);
+    void remove(uint32_t id);
+    void clear();
+
+    // leading edge moved from `from` to `to` (degrees) in `direction` (-1 for
+    // decreasing angle, RadarGeometry's default, +1 otherwise); a full turn
+    // or more is given as `swept` >= 360. Crossed ids are appended to `out`.
+    void cross(float from, float to, int direction, double now, std::vector<uint32_t> &out, float swept = 0.0f);
+
+    // 1 right after the beam crossed, fading to 0 over fadeSeconds
+    float highlight(uint32_t id, double now) const;
+    const Target &get(uint32_t id) const { return targets[id]; }
+    size_t size() const { return index.size(); }
+
+private:
+    struct Entry
+    {
+        float azimuth;
+        uint32_t id;
+    };
+
+    double fadeSeconds;
+    std::vector<Target> targets;
+    std::vector<uint32_t> freeIds;
+    std::vector<Entry> index; // sorted by azimuth
+
+    void insertEntry(float azimuth, uint32_t id);
+    void eraseEntry(float azimuth, uint32_t id);
+    // ids with azimuth in [lo, hi)
+    void collect(float lo, float hi, double now, std::vector<uint32_t> &out);
+};
+
+#endif
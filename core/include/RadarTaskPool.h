@@ -0,0 +1,55 @@
+#ifndef RadarTaskPool_H
+#define RadarTaskPool_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Small fixed pool of worker threads for data-parallel loops (spoke decode,
+// signal processing, geometry). The calling thread works on its own loop
+// too, so a pool with zero workers simply runs everything inline.
+class RadarTaskPool
+{
+public:
+    // threads: workers to start, -1 for one less than the hardware threads
+    explicit RadarTaskPool(int threads = -1);
+    ~RadarTaskPool();
+
+    // run fn(begin, end) over [0, count) in chunks of at least grain items,
+    // returns once every chunk has finished
+    void parallelFor(size_t count, const std::function<void(size_t, size_t)> &fn, size_t grain = 1);
+
+    int getThreadCount() const { return (int)workers.size(); }
+
+    // process-wide pool shared by the decode and processing stages
+    static RadarTaskPool &shared();
+
+private:
+    struct Job
+    {
+        const std::function<void(size_t, size_t)> *fn;
+        size_t count;
+        size_t chunk;
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+        int users = 0; // workers inside runChunks, guarded by mutex
+    };
+
+    std::vector<std::thread> workers;
+    std::deque<Job *> jobs;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    bool stopping = false;
+
+    void workerLoop();
+    // claim and run chunks until none are left
+    void runChunks(Job &job);
+};
+
+#endif
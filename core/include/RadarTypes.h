@@ -25,4 +25,25 @@ struct RadarVertex
     Vec4 color;
 };
 
+// one range cell that passed the video thresholds (RadarVideoProcessor)
+struct RadarDetection
+{
+    int azimuth; // row in the polar image
+    int bin;
+    int amplitude; // clutter-suppressed amplitude
+};
+
+// cluster of connected detections (RadarPlotExtractor)
+struct RadarPlot
+{
+    float azimuth; // amplitude-weighted centroid, degrees
+    float range;   // amplitude-weighted centroid, bins
+    float azimuthStart; // degrees, larger than azimuthEnd when the plot spans north
+    float azimuthEnd;
+    int rangeStart; // bins, inclusive
+    int rangeEnd;
+    int peak;
+    int cells;
+};
+
 #endif
\ No newline at end of file
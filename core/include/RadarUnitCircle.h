@@ -0,0 +1,107 @@
+#ifndef RadarUnitCircle_H
+#define RadarUnitCircle_H
+
+// Unit-circle tables computed at compile time for the segment counts used
+// by the grid. Entry i holds cos/sin of the same float angle
+// 2 * PI * i / Segments that RadarGeometry computes at run time, evaluated in
+// double like ::cos/::sin, so table-driven geometry matches the runtime path.
+
+namespace RadarTrig
+{
+    // pi/2 split in two doubles for an exact range reduction
+    constexpr double HALF_PI_HI = 1.57079632679489655800e+00;
+    constexpr double HALF_PI_LO = 6.12323399573676603587e-17;
+
+    // Taylor series, |x| <= pi/4; the last term is far below double precision
+    constexpr double sinKernel(double x)
+    {
+        double x2 = x * x;
+        double term = x;
+        double sum = x;
+        for (int n = 1; n < 12; n++)
+        {
+            term *= -x2 / ((2 * n) * (2 * n + 1));
+            sum += term;
+        }
+        return sum;
+    }
+
+    constexpr double cosKernel(double x)
+    {
+        double x2 = x * x;
+        double term = 1.0;
+        double sum = 1.0;
+        for (int n = 1; n < 12; n++)
+        {
+            term *= -x2 / ((2 * n - 1) * (2 * n));
+            sum += term;
+        }
+        return sum;
+    }
+
+    // quadrant of x and the remainder in [-pi/4, pi/4], x >= 0
+    constexpr int quadrant(double x, double &r)
+    {
+        long long q = (long long)(x / HALF_PI_HI + 0.5);
+        r = (x - q * HALF_PI_HI) - q * HALF_PI_LO;
+        return (int)(q & 3);
+    }
+
+    constexpr double cos(double x)
+    {
+        double r = 0.0;
+        switch (quadrant(x, r))
+        {
+        case 0:
+            return cosKernel(r);
+        case 1:
+            return -sinKernel(r);
+        case 2:
+            return -cosKernel(r);
+        default:
+            return sinKernel(r);
+        }
+    }
+
+    constexpr double sin(double x)
+    {
+        double r = 0.0;
+        switch (quadrant(x, r))
+        {
+        case 0:
+            return sinKernel(r);
+        case 1:
+            return cosKernel(r);
+        case 2:
+            return -sinKernel(r);
+        default:
+            return -cosKernel(r);
+        }
+    }
+}
+
+// Segments + 1 entries, the last one closes the circle
+template <int Segments>
+struct RadarUnitCircle
+{
+    static_assert(Segments > 0, "a circle needs at least one segment");
+
+    double cos[Segments + 1];
+    double sin[Segments + 1];
+
+    constexpr RadarUnitCircle() : cos(), sin()
+    {
+        const float PI = 3.14159265358979323846f;
+        for (int i = 0; i <= Segments; i++)
+        {
+            float th = 2 * PI * i / Segments;
+            cos[i] = RadarTrig::cos(th);
+            sin[i] = RadarTrig::sin(th);
+        }
+    }
+};
+
+template <int Segments>
+inline constexpr RadarUnitCircle<Segments> radarUnitCircle{};
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef RadarVideoProcessor_H
+#define RadarVideoProcessor_H
+
+#include <cstdint>
+#include <vector>
+#include "RadarPolarImage.h"
+#include "RadarTypes.h"
+
+class RadarTaskPool;
+
+// one spoke of raw 8-bit video for batch processing
+struct RadarSpokeInput
+{
+    int azimuth; // row in the polar image
+    const uint8_t *data;
+    int bins;
+};
+
+// Background suppression for incoming spokes:
+//  1. recursive clutter map, an exponential average per azimuth/range cell,
+//     subtracted (plus a margin) from the raw amplitude
+//  2. cell-averaging CFAR along range on the residual: a cell is kept when it
+//     exceeds `cfarScale` times the mean of the reference cells on both sides,
+//     skipping `guardCells` next to it
+// Output is thresholded video (zero below threshold) plus the detection list.
+// Kernels are SSE2 where available with a bit-identical scalar fallback.
+class RadarVideoProcessor
+{
+public:
+    struct Config
+    {
+        int azimuths = 4096;
+        int bins = 2048;
+        int clutterShift = 4;  // map weight per revolution is 1 / 2^shift, 1..8
+        int clutterMargin = 8; // amplitude over the clutter map before a cell counts
+        int guardCells = 2;
+        int referenceCells = 16; // per side
+        float cfarScale = 2.0f;
+    };
+
+    explicit RadarVideoProcessor(const Config &config, RadarTaskPool *pool = nullptr);
+
+    const Config &getConfig() const { return config; }
+
+    // process one spoke, writing `config.bins` cells to out and appending hits
+    void processSpoke(int azimuth, const uint8_t *in, int bins, uint8_t *out, std::vector<RadarDetection> &detections);
+
+    // process spokes in parallel on the task pool into their image rows;
+    // azimuths within one batch must be distinct (each owns its clutter row).
+    // Detections are appended in spoke order.
+    void process(const RadarSpokeInput *spokes, int count, RadarPolarImage &image, std::vector<RadarDetection> &detections);
+
+    // forget the learned background, e.g. after a range scale change
+    void resetClutter();
+
+private:
+    Config config;
+    RadarTaskPool *pool;
+    std::vector<uint16_t> clutter; // 8.8 fixed point, azimuths x bins
+    std::vector<float> cfarFactor; // cfarScale / reference count, indexed by count
+    std::vector<std::vector<RadarDetection>> spokeDetections;
+    uint64_t nextVersion = 1;
+
+    void suppressClutter(uint16_t *map, const uint8_t *in, uint8_t *residual, int bins) const;
+    void cfar(int azimuth, const uint8_t *residual, const uint32_t *prefix, uint8_t *out, int bins,
+              std::vector<RadarDetection> &detections) const;
+};
+
+#endif
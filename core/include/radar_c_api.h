@@ -2,6 +2,7 @@
 #define radar_c_api_h
 
 #include "RadarGeometry.h"
+#include "RadarFrameExport.h"
 
 #ifdef _WIN32
 #ifdef RADAR_BUILD_DLL
@@ -13,6 +14,28 @@
 #define RADAR_API
 #endif
 
+// Batch descriptor for radar_geo_generate_batch, blittable so a C# host can
+// pass a pinned array and read `written` / `angle` back in place.
+enum RadarGeoBatchKind
+{
+    RADAR_GEO_RINGS = 0,
+    RADAR_GEO_RADIALS = 1,
+    RADAR_GEO_SWEEP = 2
+};
+
+struct RadarGeoBatchDesc
+{
+    RadarGeometry *geo;
+    int kind;      // RadarGeoBatchKind
+    int count;     // rings or radials, unused for the sweep
+    int segment;
+    float deltaTime; // sweep only
+    RadarVertex *outVerts;
+    int maxVerts;
+    int written; // out: vertices copied, or required count if maxVerts is too small for a sweep
+    float angle; // out: sweep angle after generation
+};
+
 extern "C"
 {
     // Create & destroy
@@ -26,6 +49,24 @@ extern "C"
     RADAR_API int radar_geo_generate_rings(RadarGeometry *geo, int rings, int segment, void *outVerts, int maxVerts);
     RADAR_API int radar_geo_generate_radials(RadarGeometry *geo, int radials, int segment, void *outVerts, int maxVerts);
     RADAR_API int radar_geo_generate_sweep(RadarGeometry *geo, float deltaTime, int segment, RadarVertex *outVerts, int maxVerts);
+    // run every descriptor in one call, returns the total vertices written
+    RADAR_API int radar_geo_generate_batch(RadarGeoBatchDesc *descs, int count);
+
+    // Sweep clock: angle follows a monotonic clock, optionally phase locked to antenna azimuth reports
+    RADAR_API void radar_geo_report_azimuth(RadarGeometry *geo, float azimuth);
+    RADAR_API void radar_geo_set_phase_lock(RadarGeometry *geo, int enabled);
+    RADAR_API void radar_geo_set_manual_clock(RadarGeometry *geo, int manual);
+
+    // Shared-memory frame ring (layout in RadarFrameRing.h) for consumers in other processes
+    RADAR_API RadarFrameExport *radar_export_create(const char *name, int slotCount, int slotBytes);
+    RADAR_API void radar_export_destroy(RadarFrameExport *exporter);
+    // generate the sweep and publish it to the ring, returns vertices written or 0 if it does not fit
+    RADAR_API int radar_geo_export_sweep(RadarGeometry *geo, RadarFrameExport *exporter, float deltaTime, int segment);
+
+    // Sector-scan radars: rings, radials and sweep limited to the arc from start
+    // counter-clockwise to end (degrees), start == end for the full circle;
+    // scan != 0 moves the sweep back and forth across the arc. Same thread as the generators.
+    RADAR_API void radar_geo_set_sector(RadarGeometry *geo, float start, float end, int scan);
 
     RADAR_API float radar_geo_get_angle(RadarGeometry *geo);
     RADAR_API float radar_geo_get_tolerance(RadarGeometry *geo);
@@ -0,0 +1,297 @@
+#include "RadarFrameExport.h"
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// the ring lives in memory shared with other processes, so the sequence and
+// counter words are accessed as lock-free atomics in place
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) && sizeof(std::atomic<uint64_t>) == sizeof(uint64_t),
+              "atomics must match the shared layout");
+
+static std::atomic<uint32_t> &sequenceOf(RadarFrameSlotHeader *slot)
+{
+    return *reinterpret_cast<std::atomic<uint32_t> *>(&slot->sequence);
+}
+
+static std::atomic<uint64_t> &publishedOf(RadarFrameRingHeader *header)
+{
+    return *reinterpret_cast<std::atomic<uint64_t> *>(&header->published);
+}
+
+bool RadarSharedRegion::create(const std::string &name, size_t size)
+{
+    close();
+#ifdef _WIN32
+    std::string path = "Local\\" + name;
+    HANDLE handle = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                       (DWORD)((uint64_t)size >> 32), (DWORD)size, path.c_str());
+    if (!handle)
+        return false;
+
+    base = static_cast<uint8_t *>(MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, size));
+    if (!base)
+    {
+        CloseHandle(handle);
+        return false;
+    }
+    mapping = handle;
+#else
+    std::string path = "/" + name;
+    int fd = shm_open(path.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0)
+        return false;
+
+    if (ftruncate(fd, (off_t)size) != 0)
+    {
+        ::close(fd);
+        shm_unlink(path.c_str());
+        return false;
+    }
+
+    void *ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (ptr == MAP_FAILED)
+    {
+        shm_unlink(path.c_str());
+        return false;
+    }
+    base = static_cast<uint8_t *>(ptr);
+#endif
+    length = size;
+    this->name = name;
+    owner = true;
+    return true;
+}
+
+bool RadarSharedRegion::open(const std::string &name)
+{
+    close();
+#ifdef _WIN32
+    std::string path = "Local\\" + name;
+    HANDLE handle = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, path.c_str());
+    if (!handle)
+        return false;
+
+    base = static_cast<uint8_t *>(MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, 0));
+    MEMORY_BASIC_INFORMATION info;
+    if (!base || !VirtualQuery(base, &info, sizeof(info)))
+    {
+        if (base)
+            UnmapViewOfFile(base);
+        base = nullptr;
+        CloseHandle(handle);
+        return false;
+    }
+    mapping = handle;
+    length = info.RegionSize;
+#else
+    std::string path = "/" + name;
+    // read-write: readers use atomic loads on the sequence words
+    int fd = shm_open(path.c_str(), O_RDWR, 0);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    void *ptr = mmap(nullptr, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (ptr == MAP_FAILED)
+        return false;
+    base = static_cast<uint8_t *>(ptr);
+    length = (size_t)st.st_size;
+#endif
+    this->name = name;
+    owner = false;
+    return true;
+}
+
+void RadarSharedRegion::close()
+{
+    if (!base)
+        return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(base);
+    CloseHandle((HANDLE)mapping);
+    mapping = nullptr;
+#else
+    munmap(base, length);
+    // readers that still have it mapped keep their view
+    if (owner)
+        shm_unlink(("/" + name).c_str());
+#endif
+    base = nullptr;
+    length = 0;
+}
+
+// --- writer
+
+int64_t RadarFrameExport::now()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+bool RadarFrameExport::create(const std::string &name, int slotCount, size_t slotSize)
+{
+    if (slotCount <= 0 || slotSize == 0 || slotSize > UINT32_MAX)
+        return false;
+
+    size_t stride = (sizeof(RadarFrameSlotHeader) + slotSize + 63) & ~size_t(63);
+    size_t total = sizeof(RadarFrameRingHeader) + stride * slotCount;
+    if (!region.create(name, total))
+    {
+        std::cerr << "RadarFrameExport: cannot create shared memory " << name << "\n";
+        return false;
+    }
+
+    memset(region.data(), 0, total);
+    auto *header = reinterpret_cast<RadarFrameRingHeader *>(region.data());
+    header->version = RADAR_FRAME_RING_VERSION;
+    header->slotCount = (uint32_t)slotCount;
+    header->slotSize = (uint32_t)slotSize;
+    header->slotStride = (uint32_t)stride;
+
+    // magic last, readers treat the ring as ready once it is set
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = RADAR_FRAME_RING_MAGIC;
+    return true;
+}
+
+size_t RadarFrameExport::getSlotSize() const
+{
+    if (!region.data())
+        return 0;
+    return reinterpret_cast<const RadarFrameRingHeader *>(region.data())->slotSize;
+}
+
+RadarFrameSlotHeader *RadarFrameExport::slotAt(uint64_t index) const
+{
+    auto *header = reinterpret_cast<RadarFrameRingHeader *>(region.data());
+    uint8_t *slots = region.data() + sizeof(RadarFrameRingHeader);
+    return reinterpret_cast<RadarFrameSlotHeader *>(slots + (index % header->slotCount) * header->slotStride);
+}
+
+RadarFrameSlotHeader *RadarFrameExport::beginWrite(uint32_t kind)
+{
+    if (!region.data())
+        return nullptr;
+
+    auto *header = reinterpret_cast<RadarFrameRingHeader *>(region.data());
+    uint64_t frame = publishedOf(header).load(std::memory_order_relaxed);
+    RadarFrameSlotHeader *slot = slotAt(frame);
+
+    auto &sequence = sequenceOf(slot);
+    sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot->kind = kind;
+    slot->frameId = frame + 1;
+    slot->timestamp = now();
+    slot->width = slot->height = slot->count = slot->size = 0;
+    slot->angle = 0.0f;
+    return slot;
+}
+
+void RadarFrameExport::endWrite(RadarFrameSlotHeader *slot)
+{
+    auto *header = reinterpret_cast<RadarFrameRingHeader *>(region.data());
+    auto &sequence = sequenceOf(slot);
+    sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    publishedOf(header).store(slot->frameId, std::memory_order_release);
+}
+
+bool RadarFrameExport::writeVertices(const std::vector<RadarVertex> &verts, float angle)
+{
+    size_t bytes = verts.size() * sizeof(RadarVertex);
+    if (bytes > getSlotSize())
+        return false;
+
+    RadarFrameSlotHeader *slot = beginWrite(RADAR_FRAME_GEOMETRY);
+    if (!slot)
+        return false;
+
+    memcpy(payload(slot), verts.data(), bytes);
+    slot->count = (uint32_t)verts.size();
+    slot->size = (uint32_t)bytes;
+    slot->angle = angle;
+    endWrite(slot);
+    return true;
+}
+
+// --- reader
+
+bool RadarFrameReader::open(const std::string &name)
+{
+    if (!region.open(name))
+        return false;
+
+    auto *header = reinterpret_cast<const RadarFrameRingHeader *>(region.data());
+    if (region.size() < sizeof(RadarFrameRingHeader) || header->magic != RADAR_FRAME_RING_MAGIC ||
+        header->version != RADAR_FRAME_RING_VERSION ||
+        sizeof(RadarFrameRingHeader) + (size_t)header->slotStride * header->slotCount > region.size())
+    {
+        std::cerr << "RadarFrameReader: " << name << " is not a frame ring\n";
+        region.close();
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return true;
+}
+
+uint64_t RadarFrameReader::getPublished() const
+{
+    if (!region.data())
+        return 0;
+    return publishedOf(reinterpret_cast<RadarFrameRingHeader *>(region.data())).load(std::memory_order_acquire);
+}
+
+bool RadarFrameReader::readLatest(RadarFrameSlotHeader &out, std::vector<uint8_t> &payload, int retries) const
+{
+    if (!region.data())
+        return false;
+
+    auto *header = reinterpret_cast<RadarFrameRingHeader *>(region.data());
+    uint8_t *slots = region.data() + sizeof(RadarFrameRingHeader);
+
+    for (int attempt = 0; attempt < retries; attempt++)
+    {
+        uint64_t published = publishedOf(header).load(std::memory_order_acquire);
+        if (published == 0)
+            return false;
+
+        auto *slot = reinterpret_cast<RadarFrameSlotHeader *>(slots + ((published - 1) % header->slotCount) * header->slotStride);
+        auto &sequence = sequenceOf(slot);
+        uint32_t seq = sequence.load(std::memory_order_acquire);
+        if (seq & 1)
+            continue;
+
+        memcpy(&out, slot, sizeof(out));
+        size_t size = out.size <= header->slotSize ? out.size : 0;
+        payload.resize(size);
+        memcpy(payload.data(), slot + 1, size);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence.load(std::memory_order_relaxed) == seq)
+        {
+            out.sequence = seq;
+            return true;
+        }
+    }
+    return false;
+}
@@ -1,16 +1,121 @@
 #include "RadarGeometry.h"
+#include "RadarTaskPool.h"
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <vector>
 
+// smallest slice of the grid handed to one task, keeps small grids inline
+static const size_t GRID_GRAIN = 4096;
+
+static float wrapDegrees(float angle)
+{
+    angle = fmodf(angle, 360.0f);
+    if (angle < 0.0f)
+        angle += 360.0f;
+    return angle;
+}
+
+void RadarGeometry::writeGrid(RadarVertex *out, int rings, int radials, int segment, size_t begin, size_t end) const
+{
+    size_t ringItems = (size_t)rings * (segment + 1);
+
+    for (size_t k = begin; k < end && k < ringItems; k++)
+    {
+        int r = (int)(k / (segment + 1)) + 1;
+        int i = (int)(k % (segment + 1));
+        float rad = r * RING_SPACING;
+        float th0 = 2 * PI * i / segment;
+        float th1 = 2 * PI * (i + 1) / segment;
+
+        RadarVertex *v = out + k * 2;
+        v[0].position = Vec2(rad * cos(th0), rad * sin(th0));
+        v[0].color = gridColor;
+        v[1].position = Vec2(rad * cos(th1), rad * sin(th1));
+        v[1].color = gridColor;
+    }
+
+    for (size_t k = begin > ringItems ? begin : ringItems; k < end; k++)
+    {
+        int i = (int)(k - ringItems);
+        float th = (2 * PI * i) / radials;
+
+        RadarVertex *v = out + k * 2;
+        v[0].position = Vec2();
+        v[0].color = gridColor;
+        v[1].position = Vec2(cos(th), sin(th));
+        v[1].color = gridColor;
+    }
+}
+
 std::vector<RadarVertex> RadarGeometry::generateGrid(int rings, int radials, int segment)
+{
+    if (hasSector())
+    {
+        auto result = generateSectorRings(rings, segment);
+        auto edges = generateRadials(radials, segment);
+        result.insert(result.end(), edges.begin(), edges.end());
+        return result;
+    }
+
+    rings = std::max(rings, 0);
+    radials = std::max(radials, 0);
+    size_t items = (size_t)rings * (segment + 1) + radials;
+
+    std::vector<RadarVertex> result(items * 2);
+    writeGrid(result.data(), rings, radials, segment, 0, items);
+    return result;
+}
+
+std::vector<RadarVertex> RadarGeometry::generateGridParallel(int rings, int radials, int segment, RadarTaskPool *pool)
+{
+    // sector grids are a fraction of the circle, not worth splitting
+    if (hasSector())
+        return generateGrid(rings, radials, segment);
+
+    rings = std::max(rings, 0);
+    radials = std::max(radials, 0);
+    size_t items = (size_t)rings * (segment + 1) + radials;
+    if (!pool)
+        pool = &RadarTaskPool::shared();
+
+    std::vector<RadarVertex> result(items * 2);
+    RadarVertex *out = result.data();
+    pool->parallelFor(items, [&](size_t begin, size_t end)
+                      { writeGrid(out, rings, radials, segment, begin, end); }, GRID_GRAIN);
+    return result;
+}
+
+std::vector<RadarVertex> RadarGeometry::generateRings(int rings, int segment)
+{
+    if (hasSector())
+        return generateSectorRings(rings, segment);
+
+    switch (segment)
+    {
+    case 64:
+        return generateRings<64>(rings);
+    case 100:
+        return generateRings<100>(rings);
+    case 128:
+        return generateRings<128>(rings);
+    case 256:
+        return generateRings<256>(rings);
+    case 360:
+        return generateRings<360>(rings);
+    default:
+        return generateRingsDynamic(rings, segment);
+    }
+}
+
+std::vector<RadarVertex> RadarGeometry::generateRingsDynamic(int rings, int segment)
 {
     std::vector<RadarVertex> result;
 
     for (int r = 1; r <= rings; r++)
     {
-        float rad = r * 0.2f;
-        for (int i = 0; i <= segment; i++)
+        float rad = r * RING_SPACING;
+        for (int i = 0; i < segment; i++)
         {
             float th0 = 2 * PI * i / segment;
             float th1 = 2 * PI * (i + 1) / segment;
@@ -27,9 +132,15 @@ std::vector<RadarVertex> RadarGeometry::generateGrid(int rings, int radials, int
         }
     }
 
-    for (int i = 0; i < radials; i++)
+    return result;
+}
+
+std::vector<RadarVertex> RadarGeometry::generateRadials(int radials, int segment)
+{
+    std::vector<RadarVertex> result;
+
+    auto push = [&](float th)
     {
-        float th = (2 * PI * i) / radials;
         RadarVertex pointA;
         pointA.position = Vec2();
         pointA.color = gridColor;
@@ -39,22 +150,43 @@ std::vector<RadarVertex> RadarGeometry::generateGrid(int rings, int radials, int
         pointB.position = Vec2(cos(th), sin(th));
         pointB.color = gridColor;
         result.push_back(pointB);
+    };
+
+    if (hasSector())
+    {
+        for (int i = 0; i < radials; i++)
+        {
+            float degrees = 360.0f * i / radials;
+            float rel = wrapDegrees(degrees - sectorStart);
+            if (rel > 0.0f && rel < sectorWidth)
+                push(degrees * PI / 180.0f);
+        }
+        push(sectorStart * PI / 180.0f);
+        push((sectorStart + sectorWidth) * PI / 180.0f);
+        return result;
+    }
+
+    for (int i = 0; i < radials; i++)
+    {
+        float th = (2 * PI * i) / radials;
+        push(th);
     }
 
     return result;
 }
 
-std::vector<RadarVertex> RadarGeometry::generateRings(int rings, int segment)
+std::vector<RadarVertex> RadarGeometry::generateSectorRings(int rings, int segment)
 {
     std::vector<RadarVertex> result;
+    int n = sectorSegments(segment);
 
     for (int r = 1; r <= rings; r++)
     {
-        float rad = r * 0.2f;
-        for (int i = 0; i < segment; i++)
+        float rad = r * RING_SPACING;
+        for (int i = 0; i < n; i++)
         {
-            float th0 = 2 * PI * i / segment;
-            float th1 = 2 * PI * (i + 1) / segment;
+            float th0 = (sectorStart + sectorWidth * i / n) * PI / 180.0f;
+            float th1 = (sectorStart + sectorWidth * (i + 1) / n) * PI / 180.0f;
 
             RadarVertex v0, v1;
             v0.position = Vec2(rad * cos(th0), rad * sin(th0));
@@ -71,35 +203,153 @@ std::vector<RadarVertex> RadarGeometry::generateRings(int rings, int segment)
     return result;
 }
 
-std::vector<RadarVertex> RadarGeometry::generateRadials(int radials, int segment)
+int RadarGeometry::sectorSegments(int segment) const
 {
-    std::vector<RadarVertex> result;
+    return std::max(1, (int)std::ceil(segment * sectorWidth / 360.0f));
+}
 
+int RadarGeometry::getRingVertexCount(int rings, int segment) const
+{
+    if (rings <= 0)
+        return 0;
+    return rings * (hasSector() ? sectorSegments(segment) : segment) * 2;
+}
+
+int RadarGeometry::getRadialVertexCount(int radials) const
+{
+    if (!hasSector())
+        return std::max(radials, 0) * 2;
+
+    int count = 2;
     for (int i = 0; i < radials; i++)
     {
-        float th = (2 * PI * i) / radials;
-        RadarVertex pointA;
-        pointA.position = Vec2();
-        pointA.color = gridColor;
-        result.push_back(pointA);
+        float rel = wrapDegrees(360.0f * i / radials - sectorStart);
+        if (rel > 0.0f && rel < sectorWidth)
+            count++;
+    }
+    return count * 2;
+}
 
-        RadarVertex pointB;
-        pointB.position = Vec2(cos(th), sin(th));
-        pointB.color = gridColor;
-        result.push_back(pointB);
+void RadarGeometry::setSector(float start, float end, bool scan)
+{
+    float width = wrapDegrees(end - start);
+    sectorStart = wrapDegrees(start);
+    sectorWidth = width > 0.0f ? width : 360.0f;
+    sectorScan = scan;
+
+    // the scan starts at the end edge, moving towards the start like the rotation
+    scanTime = clock.currentTime();
+    scanDistance = 0.0;
+    scanDirection = -1;
+}
+
+void RadarGeometry::getSectorBounds(Vec2 &lo, Vec2 &hi) const
+{
+    if (!hasSector())
+    {
+        lo = Vec2(-1.0f, -1.0f);
+        hi = Vec2(1.0f, 1.0f);
+        return;
+    }
+    getWedgeBounds(sectorStart, sectorWidth, lo, hi);
+}
+
+void RadarGeometry::getWedgeBounds(float start, float width, Vec2 &lo, Vec2 &hi)
+{
+    const float PI = 3.14159265358979323846f;
+
+    // the centre, both edges and every axis crossing inside the arc
+    lo = hi = Vec2();
+    auto include = [&](float degrees)
+    {
+        float th = degrees * PI / 180.0f;
+        float x = cos(th), y = sin(th);
+        lo = Vec2(std::min(lo.x, x), std::min(lo.y, y));
+        hi = Vec2(std::max(hi.x, x), std::max(hi.y, y));
+    };
+
+    include(start);
+    include(start + width);
+    for (int k = 0; k < 4; k++)
+    {
+        if (wrapDegrees(90.0f * k - start) <= width)
+            include(90.0f * k);
+    }
+}
+
+float RadarGeometry::scanAngle(double t)
+{
+    double period = 2.0 * sectorWidth;
+    double d = fmod(scanDistance + std::fabs(sweepSpeed) * (t - scanTime), period);
+    if (d < 0.0)
+        d += period;
+
+    if (d < sectorWidth)
+    {
+        scanDirection = -1;
+        return wrapDegrees(sectorStart + sectorWidth - (float)d);
+    }
+    scanDirection = 1;
+    return wrapDegrees(sectorStart + (float)(d - sectorWidth));
+}
+
+std::vector<RadarVertex> RadarGeometry::generateDetections(const std::vector<RadarDetection> &detections, int azimuths, int bins)
+{
+    std::vector<RadarVertex> result;
+    result.reserve(detections.size());
+
+    for (const auto &det : detections)
+    {
+        // cell centre, same polar mapping as the video texture
+        float th = 2 * PI * (det.azimuth + 0.5f) / azimuths;
+        float r = (det.bin + 0.5f) / bins;
+
+        RadarVertex point;
+        point.position = Vec2(r * cos(th), r * sin(th));
+        point.color = sweepColor;
+        point.color.a = 1.0f;
+        result.push_back(point);
     }
 
     return result;
 }
 
+void RadarGeometry::syncParameters()
+{
+    uint32_t version = published.version();
+    RadarParameters params;
+    if (version != appliedVersion && published.tryLoad(params))
+    {
+        // keep the sector scan continuous across a speed change
+        if (sectorScan && params.sweepSpeed != sweepSpeed)
+        {
+            double t = clock.currentTime();
+            scanDistance += std::fabs(sweepSpeed) * (t - scanTime);
+            scanTime = t;
+        }
+        sweepSpeed = params.sweepSpeed;
+        detTolerance = params.detTolerance;
+        appliedVersion = version;
+    }
+
+    clock.sync();
+}
+
+float RadarGeometry::advanceSweep(float deltaTime)
+{
+    syncParameters();
+
+    clock.advance(deltaTime);
+    sweepAngle = hasSector() && sectorScan ? scanAngle(clock.currentTime()) : clock.angle();
+
+    return sweepAngle;
+}
+
 std::vector<RadarVertex> RadarGeometry::generateSweep(float deltaTime, int segments)
 {
     std::vector<RadarVertex> result;
 
-    sweepAngle -= sweepSpeed * deltaTime;
-    if (sweepAngle < 0.0f)
-        sweepAngle += 360.0f;
-
+    advanceSweep(deltaTime);
     result = generateStoppedSweep(sweepAngle, segments);
 
     return result;
@@ -109,8 +359,14 @@ std::vector<RadarVertex> RadarGeometry::generateStoppedSweep(float angle, int se
 {
     std::vector<RadarVertex> result;
 
+    // an explicit angle moves the clock, later sweeps continue from here
+    if (angle != sweepAngle)
+        clock.setAngle(angle);
     sweepAngle = angle;
 
+    if (hasSector())
+        return generateSectorSweep(segments);
+
     float th0 = sweepAngle - detTolerance / 2.0f;
     float th1 = sweepAngle + detTolerance / 2.0f;
 
@@ -131,4 +387,42 @@ std::vector<RadarVertex> RadarGeometry::generateStoppedSweep(float angle, int se
     }
 
     return result;
-}
\ No newline at end of file
+}
+std::vector<RadarVertex> RadarGeometry::generateSectorSweep(int segments)
+{
+    std::vector<RadarVertex> result;
+
+    // angle relative to the sector start, negative just before it
+    float rel = wrapDegrees(sweepAngle - sectorStart);
+    if (rel > sectorWidth + (360.0f - sectorWidth) / 2.0f)
+        rel -= 360.0f;
+
+    // the wedge clipped to the sector, nothing when it is outside
+    float wedge0 = rel - detTolerance / 2.0f;
+    float lo = std::max(wedge0, 0.0f);
+    float hi = std::min(rel + detTolerance / 2.0f, sectorWidth);
+    if (lo >= hi)
+        return result;
+
+    RadarVertex center;
+    center.position = Vec2();
+    center.color = sweepColor;
+    result.push_back(center);
+
+    // opaque at the leading edge whichever way the scan moves
+    int direction = getSweepDirection();
+    for (int i = 0; i <= segments; i++)
+    {
+        float t = lo + (hi - lo) * i / segments;
+        float th = (sectorStart + t) * PI / 180.0f;
+        float u = (t - wedge0) / detTolerance;
+        float alpha = sweepColor.a * (direction < 0 ? 1.0f - u : u);
+
+        RadarVertex seg;
+        seg.position = Vec2(cos(th), sin(th));
+        seg.color = Vec4(sweepColor.r, sweepColor.g, sweepColor.b, alpha);
+        result.push_back(seg);
+    }
+
+    return result;
+}
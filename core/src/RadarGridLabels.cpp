@@ -0,0 +1,166 @@
+#include "RadarGridLabels.h"
+#include "RadarGeometry.h"
+// only stb_easy_font_print is used, the header's other static helpers
+// would warn as unused
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-function"
+#endif
+#include "stb_easy_font.h"
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+// stb glyph units to pixels, same size as the info window text
+static const float LABEL_SCALE = 2.0f;
+// stb cap height in glyph units
+static const float GLYPH_HEIGHT = 7.0f;
+// gap between a label and the line it annotates, pixels
+static const float LABEL_GAP = 3.0f;
+
+struct LabelQuadVertex
+{
+    float x, y, z;
+    unsigned char c[4];
+};
+
+int RadarGridLabels::zoomBucket(int pixels)
+{
+    if (pixels < 1)
+        pixels = 1;
+    return (int)std::lround(4.0 * std::log2((double)pixels));
+}
+
+RadarGridLabels::Key RadarGridLabels::makeKey(int rings, int radials, int width, int height, const Vec4 &color,
+                                              float sectorStart, float sectorWidth) const
+{
+    Key k;
+    k.rings = rings;
+    k.radials = radials;
+    k.bucketW = zoomBucket(width);
+    k.bucketH = zoomBucket(height);
+    k.range = range;
+    k.sectorStart = sectorStart;
+    k.sectorWidth = sectorWidth;
+    k.color = color;
+    return k;
+}
+
+bool RadarGridLabels::isCurrent(int rings, int radials, int width, int height, const Vec4 &color,
+                                float sectorStart, float sectorWidth) const
+{
+    Key k = makeKey(rings, radials, width, height, color, sectorStart, sectorWidth);
+    return k.rings == key.rings && k.radials == key.radials && k.bucketW == key.bucketW &&
+           k.bucketH == key.bucketH && k.range == key.range && k.sectorStart == key.sectorStart &&
+           k.sectorWidth == key.sectorWidth && memcmp(&k.color, &key.color, sizeof(Vec4)) == 0;
+}
+
+const std::vector<RadarVertex> &RadarGridLabels::build(int rings, int radials, int width, int height, const Vec4 &color,
+                                                       float sectorStart, float sectorWidth)
+{
+    if (isCurrent(rings, radials, width, height, color, sectorStart, sectorWidth))
+        return vertices;
+
+    key = makeKey(rings, radials, width, height, color, sectorStart, sectorWidth);
+    vertices.clear();
+
+    // NDC per pixel at the bucket's representative size
+    float pxW = 2.0f / std::exp2(key.bucketW / 4.0f);
+    float pxH = 2.0f / std::exp2(key.bucketH / 4.0f);
+    const float PI = 3.14159265358979323846f;
+    char text[32];
+
+    // distance from a label's centre to its edge along (x, y), plus the gap
+    auto clearance = [](const char *text, float x, float y)
+    {
+        float w = stb_easy_font_width(const_cast<char *>(text)) * LABEL_SCALE;
+        float h = GLYPH_HEIGHT * LABEL_SCALE;
+        return std::fabs(x) * w / 2.0f + std::fabs(y) * h / 2.0f + LABEL_GAP;
+    };
+
+    // range labels just inside their ring, between the first two radials
+    // (of the sector, if there is one)
+    float ringAngle = radials > 0 ? PI / radials : PI / 4.0f;
+    bool sector = sectorWidth < 360.0f;
+    if (sector)
+        ringAngle = (sectorStart + std::min(sectorWidth / 2.0f, 180.0f / std::max(radials, 1))) * PI / 180.0f;
+    float ringX = std::cos(ringAngle), ringY = std::sin(ringAngle);
+    for (int r = 1; r <= rings; r++)
+    {
+        float rad = r * RadarGeometry::RING_SPACING;
+        snprintf(text, sizeof(text), "%g", rad * range);
+        float inset = clearance(text, ringX, ringY);
+        addText(text, Vec2(rad * ringX, rad * ringY), -ringX * inset, -ringY * inset, pxW, pxH, color);
+    }
+
+    // bearing labels inside the outer edge, beside their radial on the
+    // counter-clockwise side so the line does not cross the text, on the
+    // clockwise side at a sector's end edge to stay inside the sector
+    for (int i = 0; i < radials; i++)
+    {
+        float th = 2 * PI * i / radials;
+        float rel = std::fmod(360.0f * i / radials - sectorStart + 720.0f, 360.0f);
+        if (sector && rel > sectorWidth)
+            continue;
+        float c = std::cos(th), s = std::sin(th);
+        snprintf(text, sizeof(text), "%d", (int)std::lround(360.0f * i / radials));
+        float inset = clearance(text, c, s);
+        float side = clearance(text, -s, c);
+        if (sector && rel > sectorWidth - 180.0f / radials)
+            side = -side;
+        addText(text, Vec2(c, s), -c * inset - s * side, -s * inset + c * side, pxW, pxH, color);
+    }
+
+    return vertices;
+}
+
+void RadarGridLabels::addText(const char *text, Vec2 anchor, float dx, float dy, float pxW, float pxH, const Vec4 &color)
+{
+    // labels are short, 64 bytes per quad
+    char buffer[8 * 1024];
+    char copy[32];
+    snprintf(copy, sizeof(copy), "%s", text);
+
+    int quads = stb_easy_font_print(0.0f, 0.0f, copy, nullptr, buffer, sizeof(buffer));
+    if (quads <= 0)
+        return;
+
+    float w = stb_easy_font_width(copy) * LABEL_SCALE;
+    float h = GLYPH_HEIGHT * LABEL_SCALE;
+    const LabelQuadVertex *quad = reinterpret_cast<const LabelQuadVertex *>(buffer);
+
+    // stb pixels are y-down from the text's top-left corner
+    auto toNdc = [&](const LabelQuadVertex &v)
+    {
+        float px = v.x * LABEL_SCALE - w / 2.0f + dx;
+        float py = h / 2.0f - v.y * LABEL_SCALE + dy;
+        return Vec2(anchor.x + px * pxW, anchor.y + py * pxH);
+    };
+
+    auto push = [&](const Vec2 &p)
+    {
+        RadarVertex v;
+        v.position = p;
+        v.color = color;
+        vertices.push_back(v);
+    };
+
+    // outline each quad with 4 segments, as TextVertex does
+    vertices.reserve(vertices.size() + quads * 8);
+    for (int q = 0; q < quads; q++, quad += 4)
+    {
+        Vec2 n0 = toNdc(quad[0]), n1 = toNdc(quad[1]), n2 = toNdc(quad[2]), n3 = toNdc(quad[3]);
+        push(n0);
+        push(n1);
+        push(n1);
+        push(n2);
+        push(n2);
+        push(n3);
+        push(n3);
+        push(n0);
+    }
+}
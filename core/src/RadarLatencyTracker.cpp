@@ -0,0 +1,111 @@
+#include "RadarLatencyTracker.h"
+#include <chrono>
+#include <cmath>
+
+// bucket b holds latencies up to 1 us * 2^((b + 1) / 4)
+static const double SUB_BUCKETS = 4.0;
+
+void RadarLatencyHistogram::add(int64_t nanos)
+{
+    if (nanos < 0)
+        nanos = 0;
+
+    int bucket = 0;
+    if (nanos > 1000)
+        bucket = (int)std::ceil(std::log2(nanos / 1000.0) * SUB_BUCKETS) - 1;
+    if (bucket < 0)
+        bucket = 0;
+    if (bucket >= BUCKETS)
+        bucket = BUCKETS - 1;
+
+    buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    sumNanos.fetch_add((uint64_t)nanos, std::memory_order_relaxed);
+
+    int64_t prev = maxNanos.load(std::memory_order_relaxed);
+    while (nanos > prev && !maxNanos.compare_exchange_weak(prev, nanos, std::memory_order_relaxed))
+    {
+    }
+}
+
+void RadarLatencyHistogram::reset()
+{
+    for (auto &bucket : buckets)
+        bucket.store(0, std::memory_order_relaxed);
+    count.store(0, std::memory_order_relaxed);
+    sumNanos.store(0, std::memory_order_relaxed);
+    maxNanos.store(0, std::memory_order_relaxed);
+}
+
+double RadarLatencyHistogram::bucketUpperMs(int bucket)
+{
+    return 0.001 * std::exp2((bucket + 1) / SUB_BUCKETS);
+}
+
+RadarLatencyHistogram::Summary RadarLatencyHistogram::summarize() const
+{
+    Summary s{};
+    uint64_t counts[BUCKETS];
+    uint64_t total = 0;
+    for (int b = 0; b < BUCKETS; b++)
+    {
+        counts[b] = buckets[b].load(std::memory_order_relaxed);
+        total += counts[b];
+    }
+    if (total == 0)
+        return s;
+
+    s.count = total;
+    // add bumps the bucket first, count may still lag the snapshot
+    uint64_t summed = count.load(std::memory_order_relaxed);
+    if (summed > 0)
+        s.meanMs = sumNanos.load(std::memory_order_relaxed) / 1e6 / summed;
+    s.maxMs = maxNanos.load(std::memory_order_relaxed) / 1e6;
+
+    // samples are added concurrently, so percentiles use the bucket snapshot
+    auto percentile = [&](double p)
+    {
+        uint64_t rank = (uint64_t)std::ceil(p * total);
+        uint64_t seen = 0;
+        for (int b = 0; b < BUCKETS; b++)
+        {
+            seen += counts[b];
+            if (seen >= rank)
+                return bucketUpperMs(b);
+        }
+        return bucketUpperMs(BUCKETS - 1);
+    };
+    // a bucket edge can lie above the largest sample
+    s.p50Ms = std::fmin(percentile(0.50), s.maxMs);
+    s.p95Ms = std::fmin(percentile(0.95), s.maxMs);
+    s.p99Ms = std::fmin(percentile(0.99), s.maxMs);
+    return s;
+}
+
+RadarLatencyTracker &RadarLatencyTracker::shared()
+{
+    static RadarLatencyTracker tracker;
+    return tracker;
+}
+
+int64_t RadarLatencyTracker::now()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+void RadarLatencyTracker::presented(const Frame &frame, int64_t presentTime)
+{
+    if (frame.receiveTimes.empty())
+        return;
+
+    record(RADAR_LATENCY_PRESENT, presentTime - frame.uploadTime);
+    for (int64_t received : frame.receiveTimes)
+        record(RADAR_LATENCY_TOTAL, presentTime - received);
+}
+
+void RadarLatencyTracker::reset()
+{
+    for (auto &stage : stages)
+        stage.reset();
+}
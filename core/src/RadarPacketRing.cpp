@@ -0,0 +1,100 @@
+#include "RadarPacketRing.h"
+#include <cstring>
+
+RadarPacketRing::RadarPacketRing(size_t capacity)
+{
+    size_t size = 4 * ALIGN;
+    while (size < capacity)
+        size *= 2;
+    buffer.assign(size, 0);
+    mask = size - 1;
+}
+
+bool RadarPacketRing::push(const void *data, size_t size, int64_t timestamp)
+{
+    if (size > getMaxPacket())
+    {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    size_t pos = head.load(std::memory_order_relaxed);
+    size_t offset = pos & mask;
+    size_t recordSize = (sizeof(Record) + size + ALIGN - 1) & ~(ALIGN - 1);
+    // space lost at the end of the buffer when the packet has to start over
+    size_t skip = offset + recordSize > buffer.size() ? buffer.size() - offset : 0;
+    size_t needed = skip + recordSize;
+
+    // the consumer's position is only reloaded when the cached one says full
+    if (pos + needed - cachedTail > buffer.size())
+    {
+        cachedTail = tail.load(std::memory_order_acquire);
+        if (pos + needed - cachedTail > buffer.size())
+        {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+
+    if (skip)
+    {
+        Record wrap = {WRAP, 0, 0};
+        memcpy(buffer.data() + offset, &wrap, sizeof(wrap));
+        offset = 0;
+    }
+    Record record = {(uint32_t)size, 0, timestamp};
+    memcpy(buffer.data() + offset, &record, sizeof(record));
+    memcpy(buffer.data() + offset + sizeof(record), data, size);
+
+    head.store(pos + needed, std::memory_order_release);
+    return true;
+}
+
+const uint8_t *RadarPacketRing::front(size_t &size, int64_t &timestamp)
+{
+    size_t pos = tail.load(std::memory_order_relaxed);
+    if (pos == cachedHead)
+    {
+        cachedHead = head.load(std::memory_order_acquire);
+        if (pos == cachedHead)
+            return nullptr;
+    }
+
+    size_t offset = pos & mask;
+    Record record;
+    memcpy(&record, buffer.data() + offset, sizeof(record));
+    size_t skip = 0;
+    if (record.size == WRAP)
+    {
+        // the packet itself was written in the same push, it is there too
+        skip = buffer.size() - offset;
+        offset = 0;
+        memcpy(&record, buffer.data(), sizeof(record));
+    }
+
+    size = record.size;
+    timestamp = record.timestamp;
+    frontSize = skip + ((sizeof(Record) + size + ALIGN - 1) & ~(ALIGN - 1));
+    return buffer.data() + offset + sizeof(Record);
+}
+
+void RadarPacketRing::pop()
+{
+    tail.store(tail.load(std::memory_order_relaxed) + frontSize, std::memory_order_release);
+    frontSize = 0;
+}
+
+bool RadarPacketRing::pop(std::string &out, int64_t *timestamp)
+{
+    size_t size;
+    int64_t stamp;
+    const uint8_t *data = front(size, stamp);
+    if (!data)
+        return false;
+
+    out.assign((const char *)data, size);
+    if (timestamp)
+        *timestamp = stamp;
+    pop();
+    return true;
+}
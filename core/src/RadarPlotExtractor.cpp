@@ -0,0 +1,223 @@
+#include "RadarPlotExtractor.h"
+#include <algorithm>
+#include <cmath>
+
+RadarPlotExtractor::RadarPlotExtractor(const Config &config) : config(config)
+{
+}
+
+void RadarPlotExtractor::reset()
+{
+    previous.clear();
+    current.clear();
+    clusters.clear();
+    freeList.clear();
+    active.clear();
+    spokeCount = 0;
+    lastAzimuth = -1;
+    unwrapped = 0;
+}
+
+int RadarPlotExtractor::allocate()
+{
+    int c;
+    if (!freeList.empty())
+    {
+        c = freeList.back();
+        freeList.pop_back();
+    }
+    else
+    {
+        c = (int)clusters.size();
+        clusters.emplace_back();
+    }
+
+    Cluster &cl = clusters[c];
+    cl.parent = c;
+    cl.stamp = spokeCount;
+    cl.cells = 0;
+    cl.peak = 0;
+    cl.rangeStart = INT32_MAX;
+    cl.rangeEnd = -1;
+    cl.azimuthStart = unwrapped;
+    cl.azimuthEnd = unwrapped;
+    cl.amplitude = 0.0;
+    cl.azimuthMoment = 0.0;
+    cl.rangeMoment = 0.0;
+    active.push_back(c);
+    return c;
+}
+
+int RadarPlotExtractor::find(int c)
+{
+    while (clusters[c].parent != c)
+    {
+        // path halving keeps chains short without recursion
+        clusters[c].parent = clusters[clusters[c].parent].parent;
+        c = clusters[c].parent;
+    }
+    return c;
+}
+
+void RadarPlotExtractor::merge(int a, int b)
+{
+    a = find(a);
+    b = find(b);
+    if (a == b)
+        return;
+    if (clusters[a].cells < clusters[b].cells)
+        std::swap(a, b);
+
+    Cluster &into = clusters[a];
+    const Cluster &from = clusters[b];
+    into.cells += from.cells;
+    into.peak = std::max(into.peak, from.peak);
+    into.rangeStart = std::min(into.rangeStart, from.rangeStart);
+    into.rangeEnd = std::max(into.rangeEnd, from.rangeEnd);
+    into.azimuthStart = std::min(into.azimuthStart, from.azimuthStart);
+    into.azimuthEnd = std::max(into.azimuthEnd, from.azimuthEnd);
+    into.amplitude += from.amplitude;
+    into.azimuthMoment += from.azimuthMoment;
+    into.rangeMoment += from.rangeMoment;
+    into.stamp = spokeCount;
+    clusters[b].parent = a;
+}
+
+void RadarPlotExtractor::emit(const Cluster &c, std::vector<RadarPlot> &plots) const
+{
+    if (c.cells < config.minCells || c.amplitude <= 0.0)
+        return;
+
+    const double toDegrees = 360.0 / config.azimuths;
+    auto wrap = [](double degrees)
+    {
+        degrees = std::fmod(degrees, 360.0);
+        return (float)(degrees < 0.0 ? degrees + 360.0 : degrees);
+    };
+
+    RadarPlot plot;
+    plot.azimuth = wrap((c.azimuthMoment / c.amplitude + 0.5) * toDegrees);
+    plot.range = (float)(c.rangeMoment / c.amplitude + 0.5);
+    plot.azimuthStart = wrap(c.azimuthStart * toDegrees);
+    plot.azimuthEnd = wrap((c.azimuthEnd + 1) * toDegrees);
+    plot.rangeStart = c.rangeStart;
+    plot.rangeEnd = c.rangeEnd;
+    plot.peak = c.peak;
+    plot.cells = c.cells;
+    plots.push_back(plot);
+}
+
+// roots not touched by this spoke are finished; merged-away clusters are only
+// referenced from runs that were just relabelled, so they can be freed too
+void RadarPlotExtractor::closeUntouched(std::vector<RadarPlot> &plots, bool all)
+{
+    size_t keep = 0;
+    for (size_t i = 0; i < active.size(); i++)
+    {
+        int c = active[i];
+        Cluster &cl = clusters[c];
+        if (cl.parent != c)
+        {
+            freeList.push_back(c);
+            continue;
+        }
+
+        if (all || cl.stamp != spokeCount)
+        {
+            emit(cl, plots);
+            freeList.push_back(c);
+            continue;
+        }
+        active[keep++] = c;
+    }
+    active.resize(keep);
+}
+
+void RadarPlotExtractor::addSpoke(int azimuth, const uint8_t *video, int bins, std::vector<RadarPlot> &plots)
+{
+    spokeCount++;
+    if (lastAzimuth >= 0)
+    {
+        // shortest signed step, so the count keeps running through north
+        int delta = azimuth - lastAzimuth;
+        if (delta > config.azimuths / 2)
+            delta -= config.azimuths;
+        else if (delta < -config.azimuths / 2)
+            delta += config.azimuths;
+        unwrapped += delta;
+    }
+    lastAzimuth = azimuth;
+
+    // runs of cells along range, short gaps bridged
+    current.clear();
+    for (int i = 0; i < bins;)
+    {
+        if (!video[i])
+        {
+            i++;
+            continue;
+        }
+
+        int start = i;
+        int end = i;
+        while (++i < bins)
+        {
+            if (video[i])
+                end = i;
+            else if (i - end > config.rangeGap)
+                break;
+        }
+        current.push_back(Run{start, end, -1});
+        i = end + 1;
+    }
+
+    // connect to overlapping runs of the previous spoke, both lists are sorted by range
+    size_t j = 0;
+    for (auto &run : current)
+    {
+        while (j < previous.size() && previous[j].end + config.rangeGap < run.start)
+            j++;
+
+        for (size_t k = j; k < previous.size() && previous[k].start <= run.end + config.rangeGap; k++)
+        {
+            if (run.label < 0)
+                run.label = find(previous[k].label);
+            else
+                merge(run.label, previous[k].label);
+        }
+
+        if (run.label < 0)
+            run.label = allocate();
+
+        Cluster &cl = clusters[find(run.label)];
+        cl.stamp = spokeCount;
+        cl.rangeStart = std::min(cl.rangeStart, run.start);
+        cl.rangeEnd = std::max(cl.rangeEnd, run.end);
+        cl.azimuthStart = std::min(cl.azimuthStart, unwrapped);
+        cl.azimuthEnd = std::max(cl.azimuthEnd, unwrapped);
+        for (int b = run.start; b <= run.end; b++)
+        {
+            int v = video[b];
+            if (!v)
+                continue;
+            cl.cells++;
+            cl.peak = std::max(cl.peak, v);
+            cl.amplitude += v;
+            cl.azimuthMoment += (double)v * unwrapped;
+            cl.rangeMoment += (double)v * b;
+        }
+    }
+
+    // labels point at roots before non-roots are freed
+    for (auto &run : current)
+        run.label = find(run.label);
+
+    closeUntouched(plots, false);
+    previous.swap(current);
+}
+
+void RadarPlotExtractor::flush(std::vector<RadarPlot> &plots)
+{
+    closeUntouched(plots, true);
+    previous.clear();
+}
@@ -0,0 +1,108 @@
+#include "RadarPolarPyramid.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RADAR_SSE2 1
+#include <emmintrin.h>
+#endif
+
+RadarPolarPyramid::RadarPolarPyramid(int maxLevels, int minBins)
+    : maxLevels(std::max(0, maxLevels)), minBins(std::max(1, minBins))
+{
+}
+
+void RadarPolarPyramid::reduceRows(const uint8_t *a, const uint8_t *b, uint8_t *out, int bins)
+{
+    int i = 0;
+
+#ifdef RADAR_SSE2
+    // 32 cells of both rows to 16 outputs: vertical max, then the max of each
+    // byte pair lands in the low byte of its 16-bit lane and is packed down
+    const __m128i lowBytes = _mm_set1_epi16(0x00FF);
+    for (; 2 * i + 32 <= bins; i += 16)
+    {
+        __m128i m0 = _mm_max_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(a + 2 * i)),
+                                  _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + 2 * i)));
+        __m128i m1 = _mm_max_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(a + 2 * i + 16)),
+                                  _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + 2 * i + 16)));
+        m0 = _mm_and_si128(_mm_max_epu8(m0, _mm_srli_epi16(m0, 8)), lowBytes);
+        m1 = _mm_and_si128(_mm_max_epu8(m1, _mm_srli_epi16(m1, 8)), lowBytes);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_packus_epi16(m0, m1));
+    }
+#endif
+
+    for (; 2 * i + 1 < bins; i++)
+        out[i] = std::max(std::max(a[2 * i], a[2 * i + 1]), std::max(b[2 * i], b[2 * i + 1]));
+    if (2 * i < bins)
+        out[i] = std::max(a[2 * i], b[2 * i]);
+}
+
+void RadarPolarPyramid::build(const RadarPolarImage &image)
+{
+    baseAzimuths = image.azimuths;
+    baseBins = image.bins;
+    levels.clear();
+    azimuthShift.assign(1, 0);
+
+    // an azimuth step at the edge spans 2 pi bins / azimuths range bins
+    const float TWO_PI = 6.28318530718f;
+    int azimuths = image.azimuths;
+    int bins = image.bins;
+    while ((int)levels.size() < maxLevels && (bins + 1) / 2 >= minBins)
+    {
+        bins = (bins + 1) / 2;
+        bool halve = azimuths % 2 == 0 && azimuths / 2 >= TWO_PI * bins;
+        if (halve)
+            azimuths /= 2;
+        azimuthShift.push_back(azimuthShift.back() + (halve ? 1 : 0));
+        levels.emplace_back(azimuths, bins);
+    }
+
+    for (int level = 1; level <= getLevelCount(); level++)
+    {
+        for (int row = 0; row < levels[level - 1].azimuths; row++)
+            reduceRow(image, level, row);
+    }
+}
+
+void RadarPolarPyramid::updateRow(const RadarPolarImage &image, int azimuth)
+{
+    if (image.azimuths != baseAzimuths || image.bins != baseBins)
+    {
+        build(image);
+        return;
+    }
+
+    for (int level = 1; level <= getLevelCount(); level++)
+        reduceRow(image, level, levelRow(level, azimuth));
+}
+
+void RadarPolarPyramid::reduceRow(const RadarPolarImage &image, int level, int row)
+{
+    const RadarPolarImage &src = level == 1 ? image : levels[level - 2];
+    RadarPolarImage &dst = levels[level - 1];
+
+    // two source rows when this level halved the azimuths, else the same one
+    int first = row;
+    int second = row;
+    if (azimuthShift[level] != azimuthShift[level - 1])
+    {
+        first = 2 * row;
+        second = std::min(first + 1, src.azimuths - 1);
+    }
+
+    reduceRows(src.row(first), src.row(second), dst.row(row), src.bins);
+    dst.rowVersion[row] = std::max(src.rowVersion[first], src.rowVersion[second]);
+}
+
+int RadarPolarPyramid::chooseLevel(float pixels, int bins, int levelCount)
+{
+    if (bins == 0 || pixels <= 0.0f)
+        return 0;
+
+    // 2^level bins per cell, rounded up so no cell falls between pixels
+    float binsPerPixel = bins / pixels;
+    int level = (int)std::ceil(std::log2(binsPerPixel) - 0.01f);
+    return std::min(std::max(level, 0), levelCount);
+}
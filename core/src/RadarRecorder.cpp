@@ -0,0 +1,117 @@
+#include "RadarRecorder.h"
+#include "RadarSpoke.h"
+#include <iostream>
+
+// stdio buffer, large enough that packets are written in big sequential chunks
+static const size_t FILE_BUFFER_SIZE = 1 << 20;
+
+RadarRecorder::RadarRecorder(uint64_t segmentBytes) : segmentBytes(segmentBytes)
+{
+}
+
+RadarRecorder::~RadarRecorder()
+{
+    close();
+}
+
+bool RadarRecorder::open(const std::string &path)
+{
+    close();
+
+    file = fopen(path.c_str(), "wb");
+    if (!file)
+    {
+        std::cerr << "RadarRecorder: cannot open " << path << "\n";
+        return false;
+    }
+
+    fileBuffer.resize(FILE_BUFFER_SIZE);
+    setvbuf(file, fileBuffer.data(), _IOFBF, fileBuffer.size());
+
+    RadarFileHeader header = {RADAR_REC_FILE_MAGIC, RADAR_REC_VERSION, 0};
+    fwrite(&header, sizeof(header), 1, file);
+
+    offset = sizeof(header);
+    segmentStart = offset;
+    packetCount = 0;
+    index.clear();
+    index.reserve(4096);
+    return true;
+}
+
+void RadarRecorder::close()
+{
+    if (!file)
+        return;
+
+    closeSegment();
+    fclose(file);
+    file = nullptr;
+}
+
+bool RadarRecorder::write(const void *data, uint32_t size, int64_t timestamp)
+{
+    if (!file)
+        return false;
+
+    RadarIndexEntry entry;
+    entry.timestamp = timestamp;
+    entry.offset = offset;
+    entry.size = size;
+    entry.azimuth = -1.0f;
+
+    RadarSpokeHeader spoke;
+    if (radarParseSpoke(data, size, spoke))
+        entry.azimuth = radarAzimuthToDegrees(spoke.azimuth);
+
+    RadarRecordHeader header = {RADAR_REC_RECORD_MAGIC, size, timestamp};
+    static const char padding[8] = {};
+    uint64_t padded = radarRecordPadded(size);
+
+    if (fwrite(&header, sizeof(header), 1, file) != 1 ||
+        fwrite(data, 1, size, file) != size ||
+        fwrite(padding, 1, padded - size, file) != padded - size)
+    {
+        std::cerr << "RadarRecorder: write failed\n";
+        return false;
+    }
+
+    offset += sizeof(header) + padded;
+    index.push_back(entry);
+    packetCount++;
+
+    if (offset - segmentStart >= segmentBytes)
+        closeSegment();
+
+    return true;
+}
+
+void RadarRecorder::flush()
+{
+    if (!file)
+        return;
+
+    closeSegment();
+    fflush(file);
+}
+
+void RadarRecorder::closeSegment()
+{
+    if (index.empty())
+        return;
+
+    RadarSegmentTrailer trailer;
+    trailer.magic = RADAR_REC_TRAILER_MAGIC;
+    trailer.count = (uint32_t)index.size();
+    trailer.segmentStart = segmentStart;
+    trailer.indexOffset = offset;
+    trailer.firstTimestamp = index.front().timestamp;
+    trailer.lastTimestamp = index.back().timestamp;
+
+    fwrite(index.data(), sizeof(RadarIndexEntry), index.size(), file);
+    fwrite(&trailer, sizeof(trailer), 1, file);
+
+    offset += index.size() * sizeof(RadarIndexEntry) + sizeof(trailer);
+    segmentStart = offset;
+    index.clear();
+}
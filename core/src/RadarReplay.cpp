@@ -0,0 +1,340 @@
+#include "RadarReplay.h"
+#include "RadarSpoke.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// longest single sleep while pacing, keeps stop() responsive
+static const std::chrono::milliseconds MAX_PACING_SLEEP(100);
+
+RadarReplay::RadarReplay()
+{
+}
+
+RadarReplay::~RadarReplay()
+{
+    close();
+}
+
+bool RadarReplay::map(const std::string &path)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(file, &fileSize);
+    if (fileSize.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    base = static_cast<const uint8_t *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!base)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    fileHandle = file;
+    mappingHandle = mapping;
+    size = (size_t)fileSize.QuadPart;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    void *addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED)
+        return false;
+
+    madvise(addr, st.st_size, MADV_SEQUENTIAL);
+    base = static_cast<const uint8_t *>(addr);
+    size = (size_t)st.st_size;
+#endif
+    return true;
+}
+
+void RadarReplay::unmap()
+{
+    if (!base)
+        return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(base);
+    CloseHandle((HANDLE)mappingHandle);
+    CloseHandle((HANDLE)fileHandle);
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+#else
+    munmap((void *)base, size);
+#endif
+    base = nullptr;
+    size = 0;
+}
+
+bool RadarReplay::open(const std::string &path)
+{
+    close();
+
+    if (!map(path))
+    {
+        std::cerr << "RadarReplay: cannot map " << path << "\n";
+        return false;
+    }
+
+    RadarFileHeader header;
+    memcpy(&header, base, std::min(size, sizeof(header)));
+    if (size < sizeof(header) || header.magic != RADAR_REC_FILE_MAGIC || header.version != RADAR_REC_VERSION)
+    {
+        std::cerr << "RadarReplay: " << path << " is not a recording\n";
+        unmap();
+        return false;
+    }
+
+    packetCount = loadSegments();
+    rewind();
+    stopRequested = false;
+    return true;
+}
+
+void RadarReplay::close()
+{
+    segments.clear();
+    recoveredIndex.clear();
+    packetCount = 0;
+    unmap();
+}
+
+uint64_t RadarReplay::loadSegments()
+{
+    const uint64_t first = sizeof(RadarFileHeader);
+    uint64_t total = 0;
+
+    // fast path: follow the trailers back from the end of the file
+    uint64_t pos = size;
+    while (pos >= first + sizeof(RadarSegmentTrailer))
+    {
+        RadarSegmentTrailer trailer;
+        memcpy(&trailer, base + pos - sizeof(trailer), sizeof(trailer));
+
+        uint64_t indexEnd = trailer.indexOffset + (uint64_t)trailer.count * sizeof(RadarIndexEntry);
+        if (trailer.magic != RADAR_REC_TRAILER_MAGIC || indexEnd + sizeof(trailer) != pos ||
+            trailer.segmentStart < first || trailer.segmentStart > trailer.indexOffset)
+            break;
+
+        Segment seg;
+        seg.entries = reinterpret_cast<const RadarIndexEntry *>(base + trailer.indexOffset);
+        seg.count = trailer.count;
+        seg.firstTimestamp = trailer.firstTimestamp;
+        seg.lastTimestamp = trailer.lastTimestamp;
+        segments.push_back(seg);
+        total += seg.count;
+        pos = trailer.segmentStart;
+    }
+
+    if (pos == first)
+    {
+        std::reverse(segments.begin(), segments.end());
+        return total;
+    }
+
+    // the file does not end on a trailer (recording was interrupted):
+    // walk the records forward, indexed segments are still used as they are
+    segments.clear();
+    total = 0;
+    pos = first;
+    for (;;)
+    {
+        uint64_t segmentStart = pos;
+        uint32_t count = 0;
+        RadarRecordHeader record;
+        while (pos + sizeof(record) <= size)
+        {
+            memcpy(&record, base + pos, sizeof(record));
+            uint64_t next = pos + sizeof(record) + radarRecordPadded(record.size);
+            if (record.magic != RADAR_REC_RECORD_MAGIC || next > size)
+                break;
+            pos = next;
+            count++;
+        }
+
+        uint64_t trailerPos = pos + (uint64_t)count * sizeof(RadarIndexEntry);
+        RadarSegmentTrailer trailer;
+        if (count > 0 && trailerPos + sizeof(trailer) <= size)
+        {
+            memcpy(&trailer, base + trailerPos, sizeof(trailer));
+            if (trailer.magic == RADAR_REC_TRAILER_MAGIC && trailer.count == count &&
+                trailer.segmentStart == segmentStart && trailer.indexOffset == pos)
+            {
+                Segment seg;
+                seg.entries = reinterpret_cast<const RadarIndexEntry *>(base + pos);
+                seg.count = count;
+                seg.firstTimestamp = trailer.firstTimestamp;
+                seg.lastTimestamp = trailer.lastTimestamp;
+                segments.push_back(seg);
+                total += count;
+                pos = trailerPos + sizeof(trailer);
+                continue;
+            }
+        }
+
+        if (count > 0)
+        {
+            recoverTail(segmentStart);
+            total += recoveredIndex.size();
+        }
+        break;
+    }
+
+    return total;
+}
+
+void RadarReplay::recoverTail(uint64_t start)
+{
+    uint64_t pos = start;
+    RadarRecordHeader record;
+    while (pos + sizeof(record) <= size)
+    {
+        memcpy(&record, base + pos, sizeof(record));
+        uint64_t next = pos + sizeof(record) + radarRecordPadded(record.size);
+        if (record.magic != RADAR_REC_RECORD_MAGIC || next > size)
+            break;
+
+        RadarIndexEntry entry;
+        entry.timestamp = record.timestamp;
+        entry.offset = pos;
+        entry.size = record.size;
+        entry.azimuth = -1.0f;
+
+        RadarSpokeHeader spoke;
+        if (radarParseSpoke(base + pos + sizeof(record), record.size, spoke))
+            entry.azimuth = radarAzimuthToDegrees(spoke.azimuth);
+
+        recoveredIndex.push_back(entry);
+        pos = next;
+    }
+
+    if (recoveredIndex.empty())
+        return;
+
+    std::cerr << "RadarReplay: recovered " << recoveredIndex.size() << " unindexed packets\n";
+
+    Segment seg;
+    seg.entries = recoveredIndex.data();
+    seg.count = (uint32_t)recoveredIndex.size();
+    seg.firstTimestamp = recoveredIndex.front().timestamp;
+    seg.lastTimestamp = recoveredIndex.back().timestamp;
+    segments.push_back(seg);
+}
+
+int64_t RadarReplay::getFirstTimestamp() const
+{
+    return segments.empty() ? 0 : segments.front().firstTimestamp;
+}
+
+int64_t RadarReplay::getLastTimestamp() const
+{
+    return segments.empty() ? 0 : segments.back().lastTimestamp;
+}
+
+void RadarReplay::seek(int64_t timestamp)
+{
+    auto seg = std::lower_bound(segments.begin(), segments.end(), timestamp,
+                                [](const Segment &s, int64_t t)
+                                { return s.lastTimestamp < t; });
+
+    segment = seg - segments.begin();
+    entry = 0;
+    if (seg == segments.end())
+        return;
+
+    const RadarIndexEntry *begin = seg->entries;
+    const RadarIndexEntry *end = seg->entries + seg->count;
+    const RadarIndexEntry *hit = std::lower_bound(begin, end, timestamp,
+                                                  [](const RadarIndexEntry &e, int64_t t)
+                                                  { return e.timestamp < t; });
+    entry = hit - begin;
+}
+
+bool RadarReplay::next(RadarPacketView &packet)
+{
+    while (segment < segments.size())
+    {
+        const Segment &seg = segments[segment];
+        if (entry < seg.count)
+        {
+            const RadarIndexEntry &e = seg.entries[entry++];
+            packet.data = base + e.offset + sizeof(RadarRecordHeader);
+            packet.size = e.size;
+            packet.timestamp = e.timestamp;
+            packet.azimuth = e.azimuth;
+            return true;
+        }
+
+        segment++;
+        entry = 0;
+    }
+
+    return false;
+}
+
+uint64_t RadarReplay::play(const std::function<void(const RadarPacketView &)> &sink, double speed)
+{
+    using namespace std::chrono;
+
+    uint64_t delivered = 0;
+
+    RadarPacketView packet;
+    steady_clock::time_point wallStart = steady_clock::now();
+    int64_t firstTimestamp = 0;
+
+    while (!stopRequested && next(packet))
+    {
+        if (delivered == 0)
+            firstTimestamp = packet.timestamp;
+
+        if (speed > 0.0)
+        {
+            auto due = wallStart + duration_cast<steady_clock::duration>(
+                                       duration<double, std::nano>((packet.timestamp - firstTimestamp) / speed));
+            while (!stopRequested && steady_clock::now() < due)
+                std::this_thread::sleep_until(std::min(due, steady_clock::now() + MAX_PACING_SLEEP));
+        }
+
+        sink(packet);
+        delivered++;
+    }
+
+    return delivered;
+}
@@ -0,0 +1,57 @@
+#include "RadarScanConverter.h"
+#include <algorithm>
+#include <cmath>
+
+void RadarScanConverter::buildTable(int width, int height, int azimuths, int bins)
+{
+    this->width = width;
+    this->height = height;
+    this->azimuths = azimuths;
+    this->bins = bins;
+    cells.resize((size_t)width * height);
+
+    const float TWO_PI = 6.28318530718f;
+    for (int y = 0; y < height; y++)
+    {
+        // pixel centres in NDC, y up
+        float ny = 1.0f - 2.0f * (y + 0.5f) / height;
+        for (int x = 0; x < width; x++)
+        {
+            float nx = 2.0f * (x + 0.5f) / width - 1.0f;
+            float r = std::sqrt(nx * nx + ny * ny);
+            uint32_t &cell = cells[(size_t)y * width + x];
+            if (r >= 1.0f)
+            {
+                cell = OUTSIDE;
+                continue;
+            }
+
+            float turn = std::atan2(ny, nx) / TWO_PI;
+            if (turn < 0.0f)
+                turn += 1.0f;
+            int row = std::min((int)(turn * azimuths), azimuths - 1);
+            int bin = std::min((int)(r * bins), bins - 1);
+            cell = (uint32_t)row * bins + bin;
+        }
+    }
+}
+
+void RadarScanConverter::convert(const RadarPolarImage &image, const RadarPolarPyramid *pyramid, int width, int height,
+                                 uint8_t *out)
+{
+    level = pyramid ? pyramid->chooseLevel(std::min(width, height) / 2.0f) : 0;
+    const RadarPolarImage &src = level > 0 ? pyramid->getLevel(level) : image;
+    if (src.azimuths == 0 || src.bins == 0)
+    {
+        std::fill(out, out + (size_t)width * height, 0);
+        return;
+    }
+
+    if (width != this->width || height != this->height || src.azimuths != azimuths || src.bins != bins)
+        buildTable(width, height, src.azimuths, src.bins);
+
+    const uint8_t *data = src.data.data();
+    size_t count = cells.size();
+    for (size_t i = 0; i < count; i++)
+        out[i] = cells[i] == OUTSIDE ? 0 : data[cells[i]];
+}
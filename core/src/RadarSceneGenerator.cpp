@@ -0,0 +1,190 @@
+#include "RadarSceneGenerator.h"
+#include "RadarSpokeCodec.h"
+#include "RadarUnitCircle.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// splitmix64 finalizer: a well mixed 64-bit value per key
+static uint64_t sceneHash(uint64_t key)
+{
+    key += 0x9E3779B97F4A7C15ull;
+    key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ull;
+    key = (key ^ (key >> 27)) * 0x94D049BB133111EBull;
+    return key ^ (key >> 31);
+}
+
+// 16-bit slice k (0..3) of a hash as a uniform value in [0, 1)
+static float sceneUniform(uint64_t hash, int k)
+{
+    return (float)((hash >> (16 * k)) & 0xFFFF) * (1.0f / 65536.0f);
+}
+
+// position bouncing between -limit and limit, moving at speed from start
+static float bounce(float start, float speed, double t, float limit)
+{
+    double period = 4.0 * limit;
+    double d = std::fmod(start + limit + speed * t, period);
+    if (d < 0.0)
+        d += period;
+    return (float)(d < 2.0 * limit ? d - limit : 3.0 * limit - d);
+}
+
+RadarSceneGenerator::RadarSceneGenerator(const Config &config) : config(config)
+{
+    this->config.spokesPerRevolution = std::max(1, config.spokesPerRevolution);
+    this->config.bins = std::min(std::max(1, config.bins), 65535 - (int)sizeof(RadarSpokeHeader) - 512);
+    this->config.rpm = std::max(0.1f, config.rpm);
+    this->config.seaState = std::min(9, std::max(0, config.seaState));
+    this->config.targets = std::max(0, config.targets);
+    const int bins = this->config.bins;
+    const uint64_t seed = sceneHash(config.seed);
+
+    // targets start inside the scope and bounce off its edge
+    for (int i = 0; i < this->config.targets; i++)
+    {
+        uint64_t h0 = sceneHash(seed ^ (0x100000000ull + i));
+        uint64_t h1 = sceneHash(h0);
+        Target t;
+        t.x = (sceneUniform(h0, 0) * 2.0f - 1.0f) * 0.65f;
+        t.y = (sceneUniform(h0, 1) * 2.0f - 1.0f) * 0.65f;
+        t.vx = (sceneUniform(h0, 2) * 2.0f - 1.0f) * config.maxSpeed;
+        t.vy = (sceneUniform(h0, 3) * 2.0f - 1.0f) * config.maxSpeed;
+        t.size = 1.0f + sceneUniform(h1, 0) * bins / 256.0f;
+        t.strength = 120.0f + sceneUniform(h1, 1) * 135.0f;
+        targets.push_back(t);
+    }
+
+    // land: a few round patches on a coarse polar grid
+    landMask.assign(LAND_AZIMUTHS * LAND_BINS, 0);
+    int patches = (int)std::lround(12.0f * std::max(0.0f, config.clutter));
+    for (int p = 0; p < patches; p++)
+    {
+        uint64_t h = sceneHash(seed ^ (0x200000000ull + p));
+        float cx = (sceneUniform(h, 0) * 2.0f - 1.0f) * 0.8f;
+        float cy = (sceneUniform(h, 1) * 2.0f - 1.0f) * 0.8f;
+        float radius = 0.04f + sceneUniform(h, 2) * 0.12f;
+        uint8_t strength = (uint8_t)(60 + sceneUniform(h, 3) * 100);
+        for (int a = 0; a < LAND_AZIMUTHS; a++)
+        {
+            double th = 2.0 * 3.14159265358979323846 * (a + 0.5) / LAND_AZIMUTHS;
+            float c = (float)RadarTrig::cos(th), s = (float)RadarTrig::sin(th);
+            for (int b = 0; b < LAND_BINS; b++)
+            {
+                float r = (b + 0.5f) / LAND_BINS;
+                float dx = r * c - cx, dy = r * s - cy;
+                if (dx * dx + dy * dy < radius * radius)
+                    landMask[a * LAND_BINS + b] = std::max(landMask[a * LAND_BINS + b], strength);
+            }
+        }
+    }
+
+    // sea clutter falls off with range, reaching further in a higher sea state
+    seaProfile.assign(bins, 0.0f);
+    float seaRange = 0.03f + 0.03f * this->config.seaState;
+    for (int b = 0; b < bins && this->config.seaState > 0; b++)
+    {
+        float r = (b + 0.5f) / bins;
+        if (r < seaRange)
+            seaProfile[b] = 10.0f * this->config.seaState * (1.0f - r / seaRange) * (1.0f - r / seaRange);
+    }
+
+    cells.resize(bins);
+}
+
+int RadarSceneGenerator::azimuthStep(uint32_t sequence) const
+{
+    // the antenna turns towards decreasing angles, like the displayed sweep
+    int step = (int)(sequence % (uint32_t)config.spokesPerRevolution);
+    return step == 0 ? 0 : config.spokesPerRevolution - step;
+}
+
+size_t RadarSceneGenerator::maxPacketSize() const
+{
+    return sizeof(RadarSpokeHeader) + std::max((size_t)config.bins, RadarSpokeCodec::maxEncodedSize(config.bins));
+}
+
+void RadarSceneGenerator::amplitudes(uint32_t sequence, uint8_t *out)
+{
+    generate(sequence);
+    memcpy(out, cells.data(), config.bins);
+}
+
+void RadarSceneGenerator::generate(uint32_t sequence)
+{
+    const int bins = config.bins;
+    const uint64_t key = sceneHash(config.seed) ^ ((uint64_t)sequence << 20);
+    int azimuth = azimuthStep(sequence);
+    const uint8_t *land = &landMask[(size_t)(azimuth * LAND_AZIMUTHS / config.spokesPerRevolution) * LAND_BINS];
+
+    // receiver noise is the magnitude of a complex sample whose I and Q are
+    // sums of two uniforms (close enough to Gaussian for a noise floor)
+    const float noiseScale = config.noise / 0.4f;
+    for (int b = 0; b < bins; b++)
+    {
+        uint64_t h0 = sceneHash(key + 2 * (uint64_t)b);
+        uint64_t h1 = sceneHash(key + 2 * (uint64_t)b + 1);
+        float i = sceneUniform(h0, 0) + sceneUniform(h0, 1) - 1.0f;
+        float q = sceneUniform(h0, 2) + sceneUniform(h0, 3) - 1.0f;
+        float amplitude = noiseScale * std::sqrt(i * i + q * q);
+
+        // sea returns are spiky, mostly low with occasional strong cells
+        float u = sceneUniform(h1, 0);
+        amplitude += seaProfile[b] * (0.3f + 2.5f * u * u * u);
+
+        uint8_t l = land[b * LAND_BINS / bins];
+        if (l)
+            amplitude += l * (0.7f + 0.3f * sceneUniform(h1, 1));
+
+        cells[b] = (uint8_t)std::min(255.0f, amplitude);
+    }
+
+    // targets lit by the beam, brightest on its axis
+    const float BEAM = 0.012f; // half beam width, across-beam range per range
+    double t = sequence * getSpokeInterval();
+    double th = 2.0 * 3.14159265358979323846 * azimuth / config.spokesPerRevolution;
+    float c = (float)RadarTrig::cos(th), s = (float)RadarTrig::sin(th);
+    for (const Target &target : targets)
+    {
+        float x = bounce(target.x, target.vx, t, 0.9f);
+        float y = bounce(target.y, target.vy, t, 0.9f);
+        float along = x * c + y * s;
+        if (along <= 0.0f || along >= 1.0f)
+            continue;
+        float across = (y * c - x * s) / (BEAM * along);
+        if (across * across >= 1.0f)
+            continue;
+
+        float peak = target.strength * (1.0f - across * across);
+        int first = (int)(along * bins);
+        int last = std::min(bins - 1, (int)(along * bins + target.size));
+        for (int b = first; b <= last; b++)
+            cells[b] = (uint8_t)std::max((float)cells[b], std::min(255.0f, peak));
+    }
+}
+
+size_t RadarSceneGenerator::spoke(uint32_t sequence, int64_t timestamp, uint8_t *packet)
+{
+    const int bins = config.bins;
+    uint8_t *payload = packet + sizeof(RadarSpokeHeader);
+
+    generate(sequence);
+    size_t payloadSize = bins;
+    if (config.encoding == RADAR_SPOKE_PACKBITS)
+        payloadSize = RadarSpokeCodec::encode(cells.data(), bins, payload);
+    else
+        memcpy(payload, cells.data(), bins);
+
+    RadarSpokeHeader header;
+    header.magic = RADAR_SPOKE_MAGIC;
+    header.version = RADAR_SPOKE_VERSION;
+    header.radarId = config.radarId;
+    header.sequence = sequence;
+    header.azimuth = (uint16_t)((uint64_t)azimuthStep(sequence) * 65536 / config.spokesPerRevolution);
+    header.bins = (uint16_t)bins;
+    header.encoding = config.encoding;
+    header.payloadSize = (uint16_t)payloadSize;
+    header.timestamp = timestamp;
+    memcpy(packet, &header, sizeof(header));
+    return sizeof(RadarSpokeHeader) + payloadSize;
+}
@@ -0,0 +1,65 @@
+#include "RadarSlabPool.h"
+
+RadarSlabPool::RadarSlabPool(size_t slabSize) : slabSize(slabSize < MAX_BLOCK ? MAX_BLOCK : slabSize)
+{
+}
+
+RadarSlabPool::~RadarSlabPool()
+{
+    for (uint8_t *slab : slabs)
+        delete[] slab;
+}
+
+int RadarSlabPool::classOf(size_t size)
+{
+    int cls = 0;
+    size_t blockSize = MIN_BLOCK;
+    while (blockSize < size)
+    {
+        blockSize <<= 1;
+        cls++;
+    }
+    return cls;
+}
+
+uint8_t *RadarSlabPool::allocate(size_t size)
+{
+    if (size > MAX_BLOCK)
+        return nullptr;
+
+    int cls = classOf(size);
+    size_t blockSize = MIN_BLOCK << cls;
+    bytesInUse += blockSize;
+
+    if (FreeBlock *block = freeLists[cls])
+    {
+        freeLists[cls] = block->next;
+        return reinterpret_cast<uint8_t *>(block);
+    }
+
+    if (remaining < blockSize)
+    {
+        // the slab tail is lost until the pool is destroyed, at most one block per class
+        cursor = new uint8_t[slabSize];
+        remaining = slabSize;
+        slabs.push_back(cursor);
+    }
+
+    uint8_t *block = cursor;
+    cursor += blockSize;
+    remaining -= blockSize;
+    return block;
+}
+
+void RadarSlabPool::release(uint8_t *block, size_t size)
+{
+    if (!block)
+        return;
+
+    int cls = classOf(size);
+    bytesInUse -= MIN_BLOCK << cls;
+
+    FreeBlock *node = reinterpret_cast<FreeBlock *>(block);
+    node->next = freeLists[cls];
+    freeLists[cls] = node;
+}
@@ -0,0 +1,68 @@
+#include "RadarSpokeCodec.h"
+#include <cstring>
+
+size_t RadarSpokeCodec::encode(const uint8_t *in, int bins, uint8_t *out)
+{
+    size_t written = 0;
+    int i = 0;
+    while (i < bins)
+    {
+        // length of the run starting at i
+        int run = 1;
+        while (i + run < bins && run < 128 && in[i + run] == in[i])
+            run++;
+
+        if (run >= 3)
+        {
+            out[written++] = (uint8_t)(257 - run);
+            out[written++] = in[i];
+            i += run;
+            continue;
+        }
+
+        // literals until the next run of 3 or the 128 byte limit
+        int start = i;
+        while (i < bins && i - start < 128)
+        {
+            if (i + 2 < bins && in[i] == in[i + 1] && in[i] == in[i + 2])
+                break;
+            i++;
+        }
+
+        int count = i - start;
+        out[written++] = (uint8_t)(count - 1);
+        memcpy(out + written, in + start, count);
+        written += count;
+    }
+
+    return written;
+}
+
+int RadarSpokeCodec::decode(const uint8_t *in, size_t size, uint8_t *out, int bins)
+{
+    size_t pos = 0;
+    int filled = 0;
+    while (pos < size && filled < bins)
+    {
+        uint8_t control = in[pos++];
+        if (control < 128)
+        {
+            int count = control + 1;
+            if (pos + count > size || filled + count > bins)
+                break;
+            memcpy(out + filled, in + pos, count);
+            pos += count;
+            filled += count;
+        }
+        else if (control > 128)
+        {
+            int count = 257 - control;
+            if (pos >= size || filled + count > bins)
+                break;
+            memset(out + filled, in[pos++], count);
+            filled += count;
+        }
+    }
+
+    return filled;
+}
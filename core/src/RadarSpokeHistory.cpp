@@ -0,0 +1,468 @@
+#include "RadarSpokeHistory.h"
+#include "RadarSpokeCodec.h"
+#include "RadarTaskPool.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+static bool seekTo(FILE *file, uint64_t offset)
+{
+#ifdef _WIN32
+    return _fseeki64(file, (long long)offset, SEEK_SET) == 0;
+#else
+    return fseeko(file, (off_t)offset, SEEK_SET) == 0;
+#endif
+}
+
+RadarSpokeHistory::RadarSpokeHistory(const Config &config, RadarTaskPool *pool)
+    : config(config), pool(pool ? pool : &RadarTaskPool::shared())
+{
+    encodeBuffer.resize(RadarSpokeCodec::maxEncodedSize(config.bins));
+}
+
+RadarSpokeHistory::~RadarSpokeHistory()
+{
+    for (auto &rev : revolutions)
+        dropRevolution(rev);
+
+    if (spill)
+    {
+        fclose(spill);
+        remove(config.spillPath.c_str());
+    }
+}
+
+void RadarSpokeHistory::addSpoke(float azimuth, int64_t timestamp, const uint8_t *data, int bins)
+{
+    int index = (int)(azimuth * config.azimuths / 360.0f) % config.azimuths;
+    if (index < 0)
+        index += config.azimuths;
+
+    std::vector<Revolution *> toSpill;
+    std::unique_lock<std::mutex> lock(mutex);
+
+    // a jump of more than half a turn means the antenna wrapped, which works
+    // for either rotation direction and survives dropped spokes
+    int step = std::abs(index - lastAzimuth);
+    if (revolutions.empty() || (lastAzimuth >= 0 && step > config.azimuths / 2))
+    {
+        Revolution rev;
+        rev.start = timestamp;
+        rev.end = timestamp;
+        rev.spokes.assign(config.azimuths, Spoke{0, 0, nullptr, 0, 0});
+        rev.lastUse = ++useCounter;
+        revolutions.push_back(std::move(rev));
+    }
+    lastAzimuth = index;
+
+    int count = std::min(bins, config.bins);
+    size_t size = RadarSpokeCodec::encode(data, count, encodeBuffer.data());
+    uint8_t *block = slabs.allocate(size);
+    if (!block)
+        return;
+    memcpy(block, encodeBuffer.data(), size);
+
+    Revolution &rev = revolutions.back();
+    Spoke &spoke = rev.spokes[index];
+    if (spoke.data)
+    {
+        // same azimuth twice in one turn, keep the newer one
+        slabs.release(spoke.data, spoke.size);
+        rev.bytes -= spoke.size;
+    }
+
+    spoke.id = nextSpokeId++;
+    spoke.timestamp = timestamp;
+    spoke.data = block;
+    spoke.size = (uint32_t)size;
+    rev.bytes += size;
+    rev.end = std::max(rev.end, timestamp);
+
+    enforceLimits(timestamp, &rev, toSpill);
+    lock.unlock();
+
+    for (Revolution *victim : toSpill)
+        spillRevolution(*victim);
+}
+
+size_t RadarSpokeHistory::memoryInUse() const
+{
+    return slabs.getBytesInUse() + revolutions.size() * (sizeof(Revolution) + config.azimuths * sizeof(Spoke));
+}
+
+void RadarSpokeHistory::enforceLimits(int64_t now, const Revolution *keep, std::vector<Revolution *> &toSpill)
+{
+    int64_t oldest = now - (int64_t)(config.retentionSeconds * 1e9);
+    while (revolutions.size() > 1 && revolutions.front().end < oldest && revolutions.front().pins == 0)
+    {
+        dropRevolution(revolutions.front());
+        revolutions.pop_front();
+    }
+
+    // memory of turns being written out is as good as freed
+    while (memoryInUse() - pendingSpill > config.memoryBudget)
+    {
+        Revolution *victim = nullptr;
+        bool pinned = false;
+        if (!config.spillPath.empty())
+        {
+            for (auto &rev : revolutions)
+            {
+                if (&rev == keep || rev.spilled || rev.spilling || rev.bytes == 0)
+                    continue;
+                if (rev.pins > 0)
+                {
+                    pinned = true;
+                    continue;
+                }
+                if (!victim || rev.lastUse < victim->lastUse)
+                    victim = &rev;
+            }
+        }
+
+        if (victim)
+        {
+            // claimed here, written by the caller once the lock is released
+            uint32_t position = 0;
+            for (auto &spoke : victim->spokes)
+            {
+                if (!spoke.data)
+                    continue;
+                spoke.spillOffset = position;
+                position += spoke.size;
+            }
+            victim->spilling = true;
+            victim->pins++;
+            victim->spillOffset = allocateSpill(victim->bytes);
+            pendingSpill += victim->bytes;
+            toSpill.push_back(victim);
+            continue;
+        }
+
+        // what is left to spill is being reconstructed: over budget until a
+        // later spoke spills it, rather than dropping history with a place on disk
+        if (pinned)
+            break;
+
+        // nowhere to spill, or only the spoke index is left: oldest history goes first
+        Revolution &front = revolutions.front();
+        if (revolutions.size() < 2 || &front == keep || front.pins > 0)
+            break;
+        dropRevolution(front);
+        revolutions.pop_front();
+    }
+}
+
+void RadarSpokeHistory::dropRevolution(Revolution &rev)
+{
+    if (rev.spilled)
+    {
+        releaseSpill(rev.spillOffset, rev.bytes);
+        rev.spilled = false;
+    }
+
+    for (auto &spoke : rev.spokes)
+    {
+        if (spoke.data)
+            slabs.release(spoke.data, spoke.size);
+        spoke.data = nullptr;
+    }
+}
+
+uint64_t RadarSpokeHistory::allocateSpill(uint64_t size)
+{
+    // first fit in the holes left by dropped or reloaded revolutions
+    for (size_t i = 0; i < spillFree.size(); i++)
+    {
+        Extent &extent = spillFree[i];
+        if (extent.size < size)
+            continue;
+
+        uint64_t offset = extent.offset;
+        extent.offset += size;
+        extent.size -= size;
+        if (extent.size == 0)
+            spillFree.erase(spillFree.begin() + i);
+        return offset;
+    }
+
+    uint64_t offset = spillEnd;
+    spillEnd += size;
+    return offset;
+}
+
+void RadarSpokeHistory::releaseSpill(uint64_t offset, uint64_t size)
+{
+    if (size == 0)
+        return;
+
+    // keep the list sorted and merge neighbours so it does not fragment
+    auto it = std::lower_bound(spillFree.begin(), spillFree.end(), offset,
+                               [](const Extent &e, uint64_t o)
+                               { return e.offset < o; });
+    it = spillFree.insert(it, Extent{offset, size});
+
+    auto next = it + 1;
+    if (next != spillFree.end() && it->offset + it->size == next->offset)
+    {
+        it->size += next->size;
+        spillFree.erase(next);
+    }
+    if (it != spillFree.begin())
+    {
+        auto prev = it - 1;
+        if (prev->offset + prev->size == it->offset)
+        {
+            prev->size += it->size;
+            spillFree.erase(it);
+        }
+    }
+}
+
+void RadarSpokeHistory::spillRevolution(Revolution &rev)
+{
+    // pinned and spilling: its spokes and extent do not change under us
+    bool written = false;
+    bool opened = true;
+    {
+        std::lock_guard<std::mutex> fileLock(fileMutex);
+        if (!spill)
+        {
+            spill = fopen(config.spillPath.c_str(), "w+b");
+            if (!spill)
+            {
+                std::cerr << "RadarSpokeHistory: cannot open spill file " << config.spillPath << "\n";
+                opened = false;
+            }
+        }
+
+        if (spill && seekTo(spill, rev.spillOffset))
+        {
+            written = true;
+            for (const auto &spoke : rev.spokes)
+            {
+                if (spoke.data && fwrite(spoke.data, 1, spoke.size, spill) != spoke.size)
+                {
+                    std::cerr << "RadarSpokeHistory: spill write failed\n";
+                    written = false;
+                    break;
+                }
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    rev.spilling = false;
+    rev.pins--;
+    pendingSpill -= rev.bytes;
+    if (!opened)
+        config.spillPath.clear();
+    // a reconstruct that pinned it meanwhile reads its spokes from memory,
+    // so they stay; a later enforceLimits claims it again
+    if (!written || rev.pins > 0)
+    {
+        releaseSpill(rev.spillOffset, rev.bytes);
+        return;
+    }
+
+    for (auto &spoke : rev.spokes)
+    {
+        if (spoke.data)
+            slabs.release(spoke.data, spoke.size);
+        spoke.data = nullptr;
+    }
+    rev.spilled = true;
+}
+
+bool RadarSpokeHistory::readSpill(uint64_t offset, uint64_t size, std::vector<uint8_t> &out)
+{
+    out.resize(size);
+    std::lock_guard<std::mutex> fileLock(fileMutex);
+    if (!spill || !seekTo(spill, offset))
+        return false;
+    return fread(out.data(), 1, size, spill) == size;
+}
+
+void RadarSpokeHistory::restoreRevolution(Revolution &rev, const std::vector<uint8_t> &extent)
+{
+    for (auto &spoke : rev.spokes)
+    {
+        if (spoke.id == 0)
+            continue;
+        spoke.data = slabs.allocate(spoke.size);
+        if (!spoke.data)
+        {
+            // out of slabs, the turn stays on disk
+            for (auto &restored : rev.spokes)
+            {
+                if (restored.data)
+                    slabs.release(restored.data, restored.size);
+                restored.data = nullptr;
+            }
+            return;
+        }
+        memcpy(spoke.data, extent.data() + spoke.spillOffset, spoke.size);
+    }
+
+    releaseSpill(rev.spillOffset, rev.bytes);
+    rev.spilled = false;
+}
+
+int RadarSpokeHistory::findRevolution(int64_t timestamp) const
+{
+    auto it = std::upper_bound(revolutions.begin(), revolutions.end(), timestamp,
+                               [](int64_t t, const Revolution &rev)
+                               { return t < rev.start; });
+    return (int)(it - revolutions.begin()) - 1;
+}
+
+bool RadarSpokeHistory::reconstruct(int64_t timestamp, RadarPolarImage &image)
+{
+    struct Row
+    {
+        int azimuth;
+        uint64_t id;
+        size_t offset; // into coded, unused for cleared rows
+        uint32_t size;
+    };
+
+    std::vector<Row> rows;
+    std::vector<uint8_t> coded;
+
+    if (image.azimuths != config.azimuths || image.bins != config.bins)
+        image.resize(config.azimuths, config.bins);
+
+    // the image at a moment is the current turn up to that moment,
+    // completed by the previous turn behind the sweep; both stay pinned
+    // while spilled ones are read without the lock
+    Revolution *turns[2] = {nullptr, nullptr};
+    bool spilled[2] = {false, false}; // as pinned, a pin keeps it that way
+    uint64_t spillOffsets[2] = {}, spillSizes[2] = {};
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        int current = findRevolution(timestamp);
+        if (current < 0)
+            return false;
+
+        turns[0] = &revolutions[current];
+        turns[1] = current > 0 ? &revolutions[current - 1] : nullptr;
+        for (int t = 0; t < 2; t++)
+        {
+            if (!turns[t])
+                continue;
+            turns[t]->lastUse = ++useCounter;
+            turns[t]->pins++;
+            spilled[t] = turns[t]->spilled;
+            if (spilled[t])
+            {
+                spillOffsets[t] = turns[t]->spillOffset;
+                spillSizes[t] = turns[t]->bytes;
+            }
+        }
+    }
+
+    std::vector<uint8_t> extents[2];
+    bool readOk = true;
+    for (int t = 0; t < 2; t++)
+        if (spillSizes[t] > 0 && !readSpill(spillOffsets[t], spillSizes[t], extents[t]))
+            readOk = false;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!readOk)
+        {
+            for (int t = 0; t < 2; t++)
+                if (turns[t])
+                    turns[t]->pins--;
+            std::cerr << "RadarSpokeHistory: spill read failed\n";
+            return false;
+        }
+
+        for (int az = 0; az < config.azimuths; az++)
+        {
+            int turn = 0;
+            const Spoke *spoke = &turns[0]->spokes[az];
+            if (spoke->id == 0 || spoke->timestamp > timestamp)
+            {
+                turn = 1;
+                spoke = turns[1] ? &turns[1]->spokes[az] : nullptr;
+            }
+
+            uint64_t id = spoke ? spoke->id : 0;
+            if (image.rowVersion[az] == id)
+                continue;
+
+            Row row = {az, id, coded.size(), 0};
+            if (id != 0)
+            {
+                const uint8_t *src = spilled[turn] ? extents[turn].data() + spoke->spillOffset : spoke->data;
+                row.size = spoke->size;
+                coded.insert(coded.end(), src, src + spoke->size);
+            }
+            rows.push_back(row);
+        }
+
+        // scrubbed turns come back into memory while they fit the budget,
+        // so stepping around one moment does not keep hitting the disk; not
+        // while another reconstruct still reads the extent
+        for (int t = 0; t < 2; t++)
+        {
+            if (!turns[t])
+                continue;
+            if (spilled[t] && turns[t]->pins == 1 &&
+                memoryInUse() - pendingSpill + turns[t]->bytes <= config.memoryBudget)
+                restoreRevolution(*turns[t], extents[t]);
+            turns[t]->pins--;
+        }
+    }
+
+    // decode outside the lock so the receive thread is never held up
+    pool->parallelFor(rows.size(), [&](size_t begin, size_t end)
+                      {
+        for (size_t i = begin; i < end; i++)
+        {
+            const Row &row = rows[i];
+            uint8_t *out = image.row(row.azimuth);
+            int written = 0;
+            if (row.id != 0)
+                written = RadarSpokeCodec::decode(coded.data() + row.offset, row.size, out, image.bins);
+            memset(out + written, 0, image.bins - written);
+            image.rowVersion[row.azimuth] = row.id;
+        } },
+                      16);
+    return true;
+}
+
+int64_t RadarSpokeHistory::getFirstTimestamp()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return revolutions.empty() ? 0 : revolutions.front().start;
+}
+
+int64_t RadarSpokeHistory::getLastTimestamp()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return revolutions.empty() ? 0 : revolutions.back().end;
+}
+
+int64_t RadarSpokeHistory::getRevolutionStart(int back)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (back < 0 || back >= (int)revolutions.size())
+        return 0;
+    return revolutions[revolutions.size() - 1 - back].start;
+}
+
+size_t RadarSpokeHistory::getMemoryInUse()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return memoryInUse();
+}
+
+size_t RadarSpokeHistory::getRevolutionCount()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return revolutions.size();
+}
@@ -0,0 +1,117 @@
+#include "RadarSweepClock.h"
+#include <chrono>
+#include <cmath>
+
+// report rate estimate smoothing and the gap after which reports are considered lost
+static const double RATE_SMOOTHING = 0.2;
+static const double REPORT_TIMEOUT = 2.0;
+
+static double wrapAngle(double angle)
+{
+    angle = fmod(angle, 360.0);
+    if (angle < 0.0)
+        angle += 360.0;
+    return angle;
+}
+
+RadarSweepClock::RadarSweepClock(float speed, float angle)
+    : published(Anchor{wrapAngle(angle), now(), speed}), nominalSpeed(speed)
+{
+    current = published.load();
+}
+
+double RadarSweepClock::now()
+{
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+void RadarSweepClock::publish(double angle, double time, double speed)
+{
+    published.store(Anchor{wrapAngle(angle), time, speed});
+}
+
+void RadarSweepClock::setSource(Source source)
+{
+    std::lock_guard<std::mutex> lock(writeMutex);
+    if (this->source.load() == source)
+        return;
+
+    // re-anchor in the new time base so the angle stays continuous
+    Anchor a = published.load();
+    double angle = a.angle - a.speed * (currentTime() - a.time);
+    this->source.store(source);
+    publish(angle, currentTime(), a.speed);
+}
+
+void RadarSweepClock::setSpeed(float degPerSec)
+{
+    std::lock_guard<std::mutex> lock(writeMutex);
+    nominalSpeed = degPerSec;
+    if (phaseLock && haveReport)
+        return; // the measured rate wins while reports are arriving
+
+    Anchor a = published.load();
+    double t = currentTime();
+    publish(a.angle - a.speed * (t - a.time), t, degPerSec);
+}
+
+void RadarSweepClock::setAngle(float angle)
+{
+    std::lock_guard<std::mutex> lock(writeMutex);
+    Anchor a = published.load();
+    publish(angle, currentTime(), a.speed);
+}
+
+void RadarSweepClock::nudge(float delta)
+{
+    std::lock_guard<std::mutex> lock(writeMutex);
+    Anchor a = published.load();
+    publish(a.angle + delta, a.time, a.speed);
+}
+
+void RadarSweepClock::setPhaseLock(bool enabled)
+{
+    std::lock_guard<std::mutex> lock(writeMutex);
+    phaseLock = enabled;
+    haveReport = false;
+}
+
+void RadarSweepClock::reportAzimuth(float azimuth, double time)
+{
+    std::lock_guard<std::mutex> lock(writeMutex);
+    if (!phaseLock)
+        return;
+
+    Anchor a = published.load();
+    double speed = a.speed;
+
+    if (haveReport && time > lastReportTime && time - lastReportTime < REPORT_TIMEOUT)
+    {
+        // shortest signed step between reports, the sweep turns towards decreasing angles
+        double step = wrapAngle(lastReportAngle - azimuth + 180.0) - 180.0;
+        double measured = step / (time - lastReportTime);
+        speed += (measured - speed) * RATE_SMOOTHING;
+    }
+    else
+    {
+        speed = nominalSpeed;
+    }
+
+    haveReport = true;
+    lastReportAngle = azimuth;
+    lastReportTime = time;
+
+    // between reports the angle is extrapolated from the last one at the measured rate
+    publish(azimuth, time, speed);
+}
+
+bool RadarSweepClock::sync()
+{
+    return published.tryLoad(current);
+}
+
+float RadarSweepClock::angleAt(double time) const
+{
+    return (float)wrapAngle(current.angle - current.speed * (time - current.time));
+}
@@ -0,0 +1,153 @@
+#include "RadarTargetStore.h"
+#include <algorithm>
+#include <cmath>
+
+static float wrapDegrees(float angle)
+{
+    angle = std::fmod(angle, 360.0f);
+    if (angle < 0.0f)
+        angle += 360.0f;
+    return angle;
+}
+
+uint32_t RadarTargetStore::add(const RadarPlot &plot)
+{
+    uint32_t id;
+    if (!freeIds.empty())
+    {
+        id = freeIds.back();
+        freeIds.pop_back();
+    }
+    else
+    {
+        id = (uint32_t)targets.size();
+        targets.emplace_back();
+    }
+
+    Target &t = targets[id];
+    t.plot = plot;
+    t.plot.azimuth = wrapDegrees(plot.azimuth);
+    t.refreshTime = -1.0;
+    t.used = true;
+    insertEntry(t.plot.azimuth, id);
+    return id;
+}
+
+void RadarTargetStore::update(uint32_t id, const RadarPlot &plot)
+{
+    if (id >= targets.size() || !targets[id].used)
+        return;
+
+    Target &t = targets[id];
+    float azimuth = wrapDegrees(plot.azimuth);
+    if (azimuth != t.plot.azimuth)
+    {
+        eraseEntry(t.plot.azimuth, id);
+        insertEntry(azimuth, id);
+    }
+    t.plot = plot;
+    t.plot.azimuth = azimuth;
+}
+
+void RadarTargetStore::remove(uint32_t id)
+{
+    if (id >= targets.size() || !targets[id].used)
+        return;
+
+    eraseEntry(targets[id].plot.azimuth, id);
+    targets[id].used = false;
+    freeIds.push_back(id);
+}
+
+void RadarTargetStore::clear()
+{
+    targets.clear();
+    freeIds.clear();
+    index.clear();
+}
+
+void RadarTargetStore::insertEntry(float azimuth, uint32_t id)
+{
+    auto it = std::upper_bound(index.begin(), index.end(), azimuth,
+                               [](float a, const Entry &e)
+                               { return a < e.azimuth; });
+    index.insert(it, Entry{azimuth, id});
+}
+
+void RadarTargetStore::eraseEntry(float azimuth, uint32_t id)
+{
+    auto it = std::lower_bound(index.begin(), index.end(), azimuth,
+                               [](const Entry &e, float a)
+                               { return e.azimuth < a; });
+    for (; it != index.end() && it->azimuth == azimuth; ++it)
+    {
+        if (it->id == id)
+        {
+            index.erase(it);
+            return;
+        }
+    }
+}
+
+void RadarTargetStore::collect(float lo, float hi, double now, std::vector<uint32_t> &out)
+{
+    auto less = [](const Entry &e, float a)
+    { return e.azimuth < a; };
+    auto it = std::lower_bound(index.begin(), index.end(), lo, less);
+    auto end = std::lower_bound(it, index.end(), hi, less);
+
+    for (; it != end; ++it)
+    {
+        targets[it->id].refreshTime = now;
+        out.push_back(it->id);
+    }
+}
+
+void RadarTargetStore::cross(float from, float to, int direction, double now, std::vector<uint32_t> &out, float swept)
+{
+    if (index.empty())
+        return;
+
+    if (swept >= 360.0f)
+    {
+        collect(0.0f, 360.0f, now, out);
+        return;
+    }
+
+    from = wrapDegrees(from);
+    to = wrapDegrees(to);
+    if (from == to)
+        return;
+
+    // the interval is half open on the `from` side, a target exactly on the
+    // edge belongs to the frame that ends there and is not crossed twice
+    float lo = direction < 0 ? to : from;
+    float hi = direction < 0 ? from : to;
+    if (direction > 0)
+    {
+        lo = std::nextafter(lo, 360.0f);
+        hi = std::nextafter(hi, 360.0f);
+    }
+
+    if (lo < hi)
+    {
+        collect(lo, hi, now, out);
+    }
+    else
+    {
+        // passes north
+        collect(lo, 360.0f, now, out);
+        collect(0.0f, hi, now, out);
+    }
+}
+
+float RadarTargetStore::highlight(uint32_t id, double now) const
+{
+    if (id >= targets.size() || !targets[id].used || targets[id].refreshTime < 0.0)
+        return 0.0f;
+
+    double age = now - targets[id].refreshTime;
+    if (age < 0.0 || age >= fadeSeconds)
+        return 0.0f;
+    return (float)(1.0 - age / fadeSeconds);
+}
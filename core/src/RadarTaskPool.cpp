@@ -0,0 +1,109 @@
+#include "RadarTaskPool.h"
+#include <algorithm>
+
+RadarTaskPool::RadarTaskPool(int threads)
+{
+    if (threads < 0)
+        threads = std::max(0, (int)std::thread::hardware_concurrency() - 1);
+
+    for (int i = 0; i < threads; i++)
+        workers.emplace_back(&RadarTaskPool::workerLoop, this);
+}
+
+RadarTaskPool::~RadarTaskPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+
+    for (auto &worker : workers)
+        worker.join();
+}
+
+RadarTaskPool &RadarTaskPool::shared()
+{
+    static RadarTaskPool pool;
+    return pool;
+}
+
+void RadarTaskPool::runChunks(Job &job)
+{
+    for (;;)
+    {
+        size_t begin = job.next.fetch_add(job.chunk);
+        if (begin >= job.count)
+            break;
+
+        size_t end = std::min(job.count, begin + job.chunk);
+        (*job.fn)(begin, end);
+        job.done.fetch_add(end - begin);
+    }
+}
+
+void RadarTaskPool::parallelFor(size_t count, const std::function<void(size_t, size_t)> &fn, size_t grain)
+{
+    if (count == 0)
+        return;
+
+    // a few chunks per thread for balance, never smaller than grain
+    size_t parts = (workers.size() + 1) * 4;
+    size_t chunk = std::max(std::max<size_t>(grain, 1), (count + parts - 1) / parts);
+
+    if (workers.empty() || chunk >= count)
+    {
+        fn(0, count);
+        return;
+    }
+
+    Job job;
+    job.fn = &fn;
+    job.count = count;
+    job.chunk = chunk;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(&job);
+    }
+    wake.notify_all();
+
+    runChunks(job);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    // the job may still be queued if no worker picked it up
+    auto it = std::find(jobs.begin(), jobs.end(), &job);
+    if (it != jobs.end())
+        jobs.erase(it);
+    // the job lives on this stack, wait until no worker touches it anymore
+    finished.wait(lock, [&job]()
+                  { return job.done.load() == job.count && job.users == 0; });
+}
+
+void RadarTaskPool::workerLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;)
+    {
+        wake.wait(lock, [this]()
+                  { return stopping || !jobs.empty(); });
+        if (stopping)
+            return;
+
+        Job *job = jobs.front();
+        if (job->next.load() >= job->count)
+        {
+            // all chunks claimed, stop offering it
+            jobs.pop_front();
+            continue;
+        }
+
+        job->users++;
+        lock.unlock();
+        runChunks(*job);
+        lock.lock();
+        job->users--;
+
+        finished.notify_all();
+    }
+}
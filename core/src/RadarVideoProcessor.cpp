@@ -0,0 +1,218 @@
+#include "RadarVideoProcessor.h"
+#include "RadarTaskPool.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RADAR_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// per-thread working rows, sized on first use
+struct ProcessScratch
+{
+    std::vector<uint8_t> residual;
+    std::vector<uint32_t> prefix;
+};
+static thread_local ProcessScratch scratch;
+
+RadarVideoProcessor::RadarVideoProcessor(const Config &config, RadarTaskPool *pool)
+    : config(config), pool(pool ? pool : &RadarTaskPool::shared())
+{
+    this->config.clutterShift = std::min(8, std::max(1, config.clutterShift));
+    this->config.clutterMargin = std::min(255, std::max(0, config.clutterMargin));
+    clutter.assign((size_t)config.azimuths * config.bins, 0);
+
+    int maxCount = 2 * config.referenceCells;
+    cfarFactor.resize(maxCount + 1, 0.0f);
+    for (int n = 1; n <= maxCount; n++)
+        cfarFactor[n] = config.cfarScale / n;
+}
+
+void RadarVideoProcessor::resetClutter()
+{
+    std::fill(clutter.begin(), clutter.end(), 0);
+}
+
+// residual = in - clutter - margin (saturating), then
+// map += in/2^shift - map/2^shift, which stays inside 16 bits without widening
+void RadarVideoProcessor::suppressClutter(uint16_t *map, const uint8_t *in, uint8_t *residual, int bins) const
+{
+    const int shift = config.clutterShift;
+    const int margin = config.clutterMargin;
+    int i = 0;
+
+#ifdef RADAR_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i margin8 = _mm_set1_epi8((char)margin);
+    const __m128i mapShift = _mm_cvtsi32_si128(shift);
+    const __m128i inShift = _mm_cvtsi32_si128(8 - shift);
+
+    for (; i + 16 <= bins; i += 16)
+    {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+        __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(map + i));
+        __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(map + i + 8));
+
+        __m128i level = _mm_packus_epi16(_mm_srli_epi16(lo, 8), _mm_srli_epi16(hi, 8));
+        __m128i r = _mm_subs_epu8(_mm_subs_epu8(x, level), margin8);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(residual + i), r);
+
+        __m128i xlo = _mm_sll_epi16(_mm_unpacklo_epi8(x, zero), inShift);
+        __m128i xhi = _mm_sll_epi16(_mm_unpackhi_epi8(x, zero), inShift);
+        lo = _mm_add_epi16(_mm_sub_epi16(lo, _mm_srl_epi16(lo, mapShift)), xlo);
+        hi = _mm_add_epi16(_mm_sub_epi16(hi, _mm_srl_epi16(hi, mapShift)), xhi);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(map + i), lo);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(map + i + 8), hi);
+    }
+#endif
+
+    for (; i < bins; i++)
+    {
+        int r = in[i] - (map[i] >> 8) - margin;
+        residual[i] = (uint8_t)std::max(0, r);
+        map[i] = (uint16_t)(map[i] - (map[i] >> shift) + (in[i] << (8 - shift)));
+    }
+}
+
+void RadarVideoProcessor::cfar(int azimuth, const uint8_t *residual, const uint32_t *prefix, uint8_t *out, int bins,
+                               std::vector<RadarDetection> &detections) const
+{
+    const int guard = config.guardCells;
+    const int window = config.referenceCells;
+
+    // edges: reference windows are clipped to the spoke
+    auto cell = [&](int i)
+    {
+        int leftEnd = std::max(0, i - guard);
+        int leftBegin = std::max(0, i - guard - window);
+        int rightBegin = std::min(bins, i + guard + 1);
+        int rightEnd = std::min(bins, i + guard + 1 + window);
+        int count = (leftEnd - leftBegin) + (rightEnd - rightBegin);
+        uint32_t sum = (prefix[leftEnd] - prefix[leftBegin]) + (prefix[rightEnd] - prefix[rightBegin]);
+
+        float threshold = count > 0 ? (float)sum * cfarFactor[count] : 0.0f;
+        bool hit = residual[i] > 0 && (float)residual[i] > threshold;
+        out[i] = hit ? residual[i] : 0;
+        if (hit)
+            detections.push_back(RadarDetection{azimuth, i, residual[i]});
+    };
+
+    // interior: both windows complete
+    int begin = std::min(bins, guard + window);
+    int end = std::max(begin, bins - guard - window);
+
+    int i = 0;
+    for (; i < begin; i++)
+        cell(i);
+
+#ifdef RADAR_SSE2
+    const __m128 factor = _mm_set1_ps(cfarFactor[2 * window]);
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= end; i += 16)
+    {
+        __m128i r8 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(residual + i));
+        __m128i r16lo = _mm_unpacklo_epi8(r8, zero);
+        __m128i r16hi = _mm_unpackhi_epi8(r8, zero);
+        __m128i r32[4] = {_mm_unpacklo_epi16(r16lo, zero), _mm_unpackhi_epi16(r16lo, zero),
+                          _mm_unpacklo_epi16(r16hi, zero), _mm_unpackhi_epi16(r16hi, zero)};
+
+        __m128i masks[4];
+        for (int k = 0; k < 4; k++)
+        {
+            int j = i + 4 * k;
+            auto at = [prefix](int index)
+            { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(prefix + index)); };
+
+            __m128i sum = _mm_add_epi32(_mm_sub_epi32(at(j - guard), at(j - guard - window)),
+                                        _mm_sub_epi32(at(j + guard + 1 + window), at(j + guard + 1)));
+            __m128 threshold = _mm_mul_ps(_mm_cvtepi32_ps(sum), factor);
+            __m128 value = _mm_cvtepi32_ps(r32[k]);
+            masks[k] = _mm_castps_si128(_mm_cmpgt_ps(value, threshold));
+        }
+
+        // residual > 0 is implied: a zero cell never exceeds a non-negative threshold
+        __m128i mask = _mm_packs_epi16(_mm_packs_epi32(masks[0], masks[1]), _mm_packs_epi32(masks[2], masks[3]));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_and_si128(r8, mask));
+
+        int bits = _mm_movemask_epi8(mask);
+        while (bits)
+        {
+            int k = 0;
+            while (!(bits & (1 << k)))
+                k++;
+            bits &= bits - 1;
+            detections.push_back(RadarDetection{azimuth, i + k, residual[i + k]});
+        }
+    }
+#endif
+
+    for (; i < bins; i++)
+        cell(i);
+}
+
+void RadarVideoProcessor::processSpoke(int azimuth, const uint8_t *in, int bins, uint8_t *out,
+                                       std::vector<RadarDetection> &detections)
+{
+    const int cells = config.bins;
+    if (azimuth < 0 || azimuth >= config.azimuths)
+        return;
+
+    if ((int)scratch.residual.size() < cells + 16)
+    {
+        scratch.residual.resize(cells + 16);
+        scratch.prefix.resize(cells + 1);
+    }
+
+    // short spokes are padded with silence, long ones cut to the configured range
+    const uint8_t *raw = in;
+    if (bins < cells)
+    {
+        memcpy(out, in, bins);
+        memset(out + bins, 0, cells - bins);
+        raw = out;
+    }
+
+    uint16_t *map = clutter.data() + (size_t)azimuth * cells;
+    uint8_t *residual = scratch.residual.data();
+    suppressClutter(map, raw, residual, cells);
+
+    uint32_t *prefix = scratch.prefix.data();
+    prefix[0] = 0;
+    for (int i = 0; i < cells; i++)
+        prefix[i + 1] = prefix[i] + residual[i];
+
+    cfar(azimuth, residual, prefix, out, cells, detections);
+}
+
+void RadarVideoProcessor::process(const RadarSpokeInput *spokes, int count, RadarPolarImage &image,
+                                  std::vector<RadarDetection> &detections)
+{
+    if (count <= 0)
+        return;
+
+    if (image.azimuths != config.azimuths || image.bins != config.bins)
+        image.resize(config.azimuths, config.bins);
+
+    if ((int)spokeDetections.size() < count)
+        spokeDetections.resize(count);
+
+    uint64_t version = nextVersion;
+    nextVersion += count;
+
+    pool->parallelFor(count, [&](size_t begin, size_t end)
+                      {
+        for (size_t s = begin; s < end; s++)
+        {
+            const RadarSpokeInput &spoke = spokes[s];
+            spokeDetections[s].clear();
+            if (spoke.azimuth < 0 || spoke.azimuth >= config.azimuths)
+                continue;
+
+            processSpoke(spoke.azimuth, spoke.data, spoke.bins, image.row(spoke.azimuth), spokeDetections[s]);
+            image.rowVersion[spoke.azimuth] = version + s;
+        } });
+
+    for (int s = 0; s < count; s++)
+        detections.insert(detections.end(), spokeDetections[s].begin(), spokeDetections[s].end());
+}
@@ -1,4 +1,6 @@
 #include "radar_c_api.h"
+#include "RadarTaskPool.h"
+#include <algorithm>
 #include <cstring>
 #include <fstream>
 #include <mutex>
@@ -105,6 +107,99 @@ int radar_geo_generate_sweep(RadarGeometry *geo, float deltaTime, int segment, R
     return count;
 }
 
+int radar_geo_generate_batch(RadarGeoBatchDesc *descs, int count)
+{
+    if (!descs || count <= 0)
+        return 0;
+
+    // rings and radials only read the geometry, so scopes are generated in
+    // parallel; sweeps advance their clock and run afterwards, in order
+    RadarTaskPool::shared().parallelFor((size_t)count, [descs](size_t begin, size_t end)
+                                        {
+        for (size_t i = begin; i < end; i++)
+        {
+            RadarGeoBatchDesc &d = descs[i];
+            d.written = 0;
+            if (!d.geo)
+                continue;
+
+            if (d.kind == RADAR_GEO_RINGS)
+                d.written = radar_geo_generate_rings(d.geo, d.count, d.segment, d.outVerts, d.maxVerts);
+            else if (d.kind == RADAR_GEO_RADIALS)
+                d.written = radar_geo_generate_radials(d.geo, d.count, d.segment, d.outVerts, d.maxVerts);
+        } });
+
+    int total = 0;
+    for (int i = 0; i < count; i++)
+    {
+        RadarGeoBatchDesc &d = descs[i];
+        if (!d.geo)
+            continue;
+
+        if (d.kind == RADAR_GEO_SWEEP)
+            d.written = radar_geo_generate_sweep(d.geo, d.deltaTime, d.segment, d.outVerts, d.maxVerts);
+
+        d.angle = d.geo->getSweepAngle();
+        if (d.written <= d.maxVerts)
+            total += d.written;
+    }
+    return total;
+}
+
+void radar_geo_report_azimuth(RadarGeometry *geo, float azimuth)
+{
+    geo->getClock().reportAzimuth(azimuth);
+}
+
+void radar_geo_set_phase_lock(RadarGeometry *geo, int enabled)
+{
+    geo->getClock().setPhaseLock(enabled != 0);
+}
+
+void radar_geo_set_manual_clock(RadarGeometry *geo, int manual)
+{
+    geo->getClock().setSource(manual ? RadarSweepClock::Manual : RadarSweepClock::Monotonic);
+}
+
+RadarFrameExport *radar_export_create(const char *name, int slotCount, int slotBytes)
+{
+    if (!name || slotBytes <= 0)
+        return nullptr;
+
+    auto exporter = new RadarFrameExport();
+    if (!exporter->create(name, slotCount, (size_t)slotBytes))
+    {
+        radar_log(std::string("radar_export_create failed: ") + name);
+        delete exporter;
+        return nullptr;
+    }
+    return exporter;
+}
+
+void radar_export_destroy(RadarFrameExport *exporter)
+{
+    delete exporter;
+}
+
+int radar_geo_export_sweep(RadarGeometry *geo, RadarFrameExport *exporter, float deltaTime, int segment)
+{
+    if (!geo || !exporter)
+        return 0;
+
+    auto verts = geo->generateSweep(deltaTime, segment);
+    if (!exporter->writeVertices(verts, geo->getSweepAngle()))
+        return 0;
+    return (int)verts.size();
+}
+
+void radar_geo_set_sector(RadarGeometry *geo, float start, float end, int scan)
+{
+    if (!geo)
+        return;
+
+    geo->setSector(start, end, scan != 0);
+}
+
 float radar_geo_get_angle(RadarGeometry *geo)
 {
     return geo->getSweepAngle();
@@ -112,7 +207,7 @@ float radar_geo_get_angle(RadarGeometry *geo)
 
 float radar_geo_get_tolerance(RadarGeometry *geo)
 {
-    return geo->getTolerance();
+    return geo->getParameters().detTolerance;
 }
 
 int radar_geo_ring_count(RadarGeometry *geo, int rings, int segment)
@@ -120,7 +215,7 @@ int radar_geo_ring_count(RadarGeometry *geo, int rings, int segment)
     if (!geo)
         return 0;
 
-    return rings * segment * 2;
+    return geo->getRingVertexCount(rings, segment);
 }
 
 int radar_geo_radial_count(RadarGeometry *geo, int radials, int segment)
@@ -128,7 +223,7 @@ int radar_geo_radial_count(RadarGeometry *geo, int radials, int segment)
     if (!geo)
         return 0;
 
-    return radials * 2;
+    return geo->getRadialVertexCount(radials);
 }
 
 int radar_geo_sweep_count(RadarGeometry *geo, int segments)
@@ -137,4 +232,4 @@ int radar_geo_sweep_count(RadarGeometry *geo, int segments)
         return 0;
 
     return 1 + (segments + 1);
-}
\ No newline at end of file
+}
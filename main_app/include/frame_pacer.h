@@ -0,0 +1,41 @@
+#ifndef frame_pacer_h
+#define frame_pacer_h
+
+#include <chrono>
+
+// Tracks frame deadlines for an animated window so the event loop can wait
+// (glfwWaitEventsTimeout) until the next frame is due instead of sleeping a
+// fixed time. Deadlines are absolute so wait error does not accumulate.
+// When the swap already blocks on vsync the next frame is due immediately;
+// if the driver ignores the swap interval (frames come back much faster than
+// the target period) the pacer falls back to its own deadlines.
+class FramePacer
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    FramePacer(double targetFps = 60.0);
+
+    void setTargetFps(double fps);
+    void setVsync(bool enabled) { vsync = enabled; }
+
+    // bracket the render + swap of the paced window
+    void beginFrame() { frameStart = Clock::now(); }
+    void endFrame();
+
+    // seconds until the next frame is due, 0 when it already is
+    double secondsUntilNextFrame() const;
+
+    // true while vsync is requested and actually throttling the swaps
+    bool vsyncEffective() const { return vsync && !vsyncIgnored; }
+
+private:
+    Clock::duration period;
+    Clock::time_point deadline;
+    Clock::time_point frameStart;
+    double avgFrameTime; // seconds, smoothed render + swap time
+    bool vsync = false;
+    bool vsyncIgnored = false;
+};
+
+#endif
@@ -4,29 +4,101 @@
 #include <string>
 #include <thread>
 #include <atomic>
+#include <memory>
+#include <vector>
+#include <functional>
 #include <mutex>
-#include <deque>
+#include <condition_variable>
+#include <cstdint>
 
+class RadarRecorder;
+class RadarPacketRing;
+
+// One endpoint the listener receives on. A multicast address (IPv4 or
+// IPv6) is joined on the given interface; any other address is bound as a
+// unicast address, an empty one on every IPv4 interface.
+struct UdpSource
+{
+    std::string address;
+    int port = 5555;           // 0: no socket, fed by injectPacket only
+    std::string interfaceName; // name or index, empty for the system default
+    size_t queueBytes = 4 << 20;
+};
+
+// Receives the configured sources on one thread, multiplexed through epoll
+// (select on Windows). Every packet is tagged with the id of the source it
+// came from and queued on that source's lock-free ring, so several radars
+// share the thread without any per-packet lock. A source with a consumer
+// gets its own thread that drains the ring as packets arrive; decoding
+// never runs on the receive thread.
 class UdpListener
 {
 public:
-    UdpListener(int port);
+    UdpListener();
     ~UdpListener();
 
+    // before start(), returns the source id (0, 1, ...)
+    int addSource(const UdpSource &source);
+    // "port", "address:port" or "[ipv6]:port", each optionally followed by "@interface"
+    static bool parseSource(const std::string &spec, UdpSource &out);
+    int getSourceCount() const { return (int)sources.size(); }
+
     void start();
     void stop();
 
+    // called on the source's own consumer thread for every queued packet, in
+    // order, set before start(); data is only valid during the call.
+    // receiveTime is the kernel receive time (wall clock ns), or the injection
+    // time for replayed packets
+    void setConsumer(int source, std::function<void(const char *data, size_t size, int64_t receiveTime)> consumer);
+
+    // polling alternative for sources without a consumer, one thread per source;
+    // packets are dropped while a queue is full
+    bool popMessage(int source, std::string &outMessage);
+    // next message of any source, for a single consumer of all of them
     bool popMessage(std::string &outMessage);
+    uint64_t getDropped(int source) const;
+
+    // every received packet is appended to the recorder, set before start()
+    void setRecorder(RadarRecorder *recorder) { this->recorder = recorder; }
+
+    // feed a packet into the same path as received ones (replay), not recorded
+    // again; the source must not receive from a socket (port 0), the injecting
+    // thread is its only producer
+    void injectPacket(int source, const char *data, size_t size, int64_t timestamp);
 
 private:
+    // drains one source's ring; sleeps on the condition variable when it is
+    // empty, the producer only takes the mutex to wake it
+    struct Consumer
+    {
+        std::function<void(const char *data, size_t size, int64_t receiveTime)> callback;
+        std::thread thread;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::atomic<bool> waiting{false};
+    };
+
+    struct Source
+    {
+        UdpSource config;
+        std::unique_ptr<RadarPacketRing> queue;
+        std::unique_ptr<Consumer> consumer;
+        intptr_t socket = -1;
+    };
+
     void listenLoop();
+    void consumeLoop(int source);
+    bool openSource(Source &source);
+    void closeSources();
+    void deliver(int source, const char *data, size_t size, int64_t timestamp, bool record);
 
-    int port;
+    std::vector<Source> sources;
+    int nextPop = 0; // round robin start for popMessage over all sources
     std::atomic<bool> running{false};
     std::thread listenThread;
 
-    std::mutex queueMutex;
-    std::deque<std::string> msgQueue;
+    RadarRecorder *recorder = nullptr;
 };
 
-#endif
\ No newline at end of file
+#endif
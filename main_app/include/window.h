@@ -9,6 +9,8 @@
 #include <stdexcept>
 #include <thread>
 #include <mutex>
+#include <atomic>
+#include <condition_variable>
 
 class Window
 {
@@ -22,19 +24,62 @@ public:
         this->userData = data;
     }
 
+    // called on the render thread right after each swap, with the render callback's data
+    void setSwapCallback(std::function<void(void *)> callback) { swapCallback = callback; }
+
+    // key presses and repeats (GLFW key codes), called on the main thread from glfwWaitEvents
+    void setKeyCallback(std::function<void(int key)> callback) { keyCallback = callback; }
+
     GLFWwindow *getHandle() const { return window; }
     void renderOnce();
-    bool init(GLFWwindow *share = nullptr);
+    bool init(GLFWwindow *share = nullptr, int swapInterval = 1);
+
+    // Render on a dedicated thread that owns this window's context, so a swap
+    // blocked on one display never delays another window. The context must not
+    // be current on any other thread. sharedReady is waited on (server side)
+    // before the first frame, for resources created by another context in the share group.
+    void startRenderThread(GLsync sharedReady = nullptr);
+    void stopRenderThread();
+
+    // redraw at targetFps (or vsync) instead of only on request
+    void setContinuous(bool enabled, double targetFps = 60.0);
+
+    // safe from any thread, wakes the render thread
+    void requestRedraw();
+    bool needsRedraw() const { return dirty.load(std::memory_order_acquire); }
 
 private:
     std::string title;
     int width;
     int height;
     float r, g, b, a;
+    int swapInterval = 1;
+
+    std::atomic<int> fbWidth{0};
+    std::atomic<int> fbHeight{0};
+    std::atomic<bool> dirty{true};
+
+    std::thread renderThread;
+    std::mutex stateMutex;
+    std::condition_variable wake;
+    bool running = false;
+    bool continuous = false;
+    double targetFps = 60.0;
+
+    // last submitted frame, at most one frame is kept in flight
+    GLsync frameFence = nullptr;
+
+    void renderLoop(GLsync sharedReady);
+
+    static void onFramebufferSize(GLFWwindow *handle, int width, int height);
+    static void onRefresh(GLFWwindow *handle);
+    static void onKey(GLFWwindow *handle, int key, int scancode, int action, int mods);
 
     GLFWwindow *window = nullptr;
     std::function<void(void *)> renderCallback;
+    std::function<void(void *)> swapCallback;
+    std::function<void(int key)> keyCallback;
     void *userData = nullptr;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,43 @@
+#include "frame_pacer.h"
+
+FramePacer::FramePacer(double targetFps)
+{
+    setTargetFps(targetFps);
+    frameStart = Clock::now();
+    deadline = frameStart;
+}
+
+void FramePacer::setTargetFps(double fps)
+{
+    period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / fps));
+    avgFrameTime = 1.0 / fps;
+}
+
+void FramePacer::endFrame()
+{
+    Clock::time_point now = Clock::now();
+    double frameTime = std::chrono::duration<double>(now - frameStart).count();
+    avgFrameTime += (frameTime - avgFrameTime) * 0.1;
+
+    // swaps returning at well over the target rate mean the swap interval is not honored
+    double target = std::chrono::duration<double>(period).count();
+    vsyncIgnored = avgFrameTime < target * 0.5;
+
+    if (vsyncEffective())
+    {
+        deadline = now;
+    }
+    else
+    {
+        // skip missed deadlines instead of bursting to catch up
+        deadline += period;
+        if (deadline < now)
+            deadline = now;
+    }
+}
+
+double FramePacer::secondsUntilNextFrame() const
+{
+    double remaining = std::chrono::duration<double>(deadline - Clock::now()).count();
+    return remaining > 0.0 ? remaining : 0.0;
+}
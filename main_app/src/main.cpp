@@ -1,20 +1,179 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
+#include <cstdio>
 #include "Window.h"
 #include "shader_util.h"
 #include "RadarGeometry.h"
+#include "RadarGridLabels.h"
+#include "RadarLatencyTracker.h"
 #include "RadarRenderer.h"
+#include "RadarSweepClock.h"
+#include "RadarPolarPyramid.h"
+#include "RadarPresentProbe.h"
+#include "RadarSpoke.h"
+#include "RadarRecorder.h"
+#include "RadarReplay.h"
+#include "RadarSpokeCodec.h"
+#include "RadarSpokeHistory.h"
+#include "RadarVideoProcessor.h"
+#include "RadarVideoRenderer.h"
 #include "udp_listener.h"
 #include "text_vertex.h"
 
-UdpListener listener(5555);
+UdpListener listener;
 struct RadarState
 {
+    // animating 60 degree per second
+    RadarSweepClock clock{60.0f};
     float sweepAngle = 0.0f;
+    // clock time of the shown radar's last spoke; the phase-locked sweep only
+    // animates while the antenna reports, idle the window redraws on demand
+    std::atomic<double> lastSpoke{-1.0e9};
+    // sector-scan coverage from --sector, start == end for the full circle;
+    // applied to the grid and video by the next frame
+    float sectorStart = 0.0f;
+    float sectorEnd = 0.0f;
+    bool sectorChanged = false;
+    // start of the swept interval uploaded by the next frame, one frame back
+    // and the latest frame's angle; set by the first frame
+    float sweptFrom[2] = {0.0f, 0.0f};
+    bool drawingSetUp = false;
+    // revolutions back in the spoke history (Left/Right, End for live), 0
+    // shows the live video; set on the main thread, applied by the next frame
+    std::atomic<int> scrubBack{0};
+    int shownScrub = 0;
+    RadarPolarImage scrubImage;
+    // spokes uploaded by the frame being drawn, handed to the present probe after the swap
+    RadarLatencyTracker::Frame latencyFrame;
+
+    bool sweepActive() const { return RadarSweepClock::now() - lastSpoke.load(std::memory_order_relaxed) < 2.0; }
+    // from the thread decoding the shown radar; wakes the main loop when the sweep was idle
+    void spokeArrived()
+    {
+        bool wasActive = sweepActive();
+        lastSpoke.store(RadarSweepClock::now(), std::memory_order_relaxed);
+        if (!wasActive)
+            glfwPostEmptyEvent();
+    }
+};
+
+// per-stage latency lines in the info window
+bool latencyOverlay = false;
+// source whose spokes drive the radar window, the others are only counted
+int shownSource = 0;
+
+// spoke counts and text messages of every source, written by the consumer
+// threads and shown by the info window
+struct InfoState
+{
+    std::vector<std::atomic<uint64_t>> spokeCounts;
+    std::mutex mutex;
+    std::vector<std::string> lines;
+};
+InfoState info;
+
+// thresholded video, written on the shown radar's consumer thread and uploaded by the radar window
+struct VideoState
+{
+    std::mutex mutex;
+    RadarVideoProcessor processor{RadarVideoProcessor::Config()};
+    RadarPolarImage image;
+    // max-reduced levels for a zoomed-out window, updated per spoke
+    RadarPolarPyramid pyramid;
+    std::vector<std::vector<RadarDetection>> rowDetections;
+    std::vector<uint8_t> decoded;
+    // receive and decode times of rows not uploaded yet, 0 when none; a row
+    // overwritten before its upload was never shown and is not traced
+    std::vector<int64_t> rowReceived, rowDecoded;
+    bool dirty = false;
+    // thresholded spokes as shown, for scrubbing back; written outside the
+    // mutex, the history has its own lock
+    RadarSpokeHistory *history = nullptr;
+    std::vector<uint8_t> historyRow;
+
+    void addSpoke(const RadarSpokeHeader &spoke, const uint8_t *payload, int64_t receiveTime)
+    {
+        const RadarVideoProcessor::Config &config = processor.getConfig();
+        std::unique_lock<std::mutex> lock(mutex);
+        if (image.azimuths == 0)
+        {
+            image.resize(config.azimuths, config.bins);
+            rowDetections.resize(config.azimuths);
+            rowReceived.assign(config.azimuths, 0);
+            rowDecoded.assign(config.azimuths, 0);
+        }
+
+        const uint8_t *cells = payload;
+        int bins = std::min<int>(spoke.bins, spoke.payloadSize);
+        if (spoke.encoding == RADAR_SPOKE_PACKBITS)
+        {
+            decoded.resize(spoke.bins);
+            bins = RadarSpokeCodec::decode(payload, spoke.payloadSize, decoded.data(), spoke.bins);
+            cells = decoded.data();
+        }
+        else if (spoke.encoding != RADAR_SPOKE_RAW8)
+        {
+            return;
+        }
+
+        int row = image.rowFor(radarAzimuthToDegrees(spoke.azimuth));
+        rowDetections[row].clear();
+        processor.processSpoke(row, cells, bins, image.row(row), rowDetections[row]);
+        pyramid.updateRow(image, row);
+        dirty = true;
+
+        int64_t decodeTime = RadarLatencyTracker::now();
+        RadarLatencyTracker::shared().decoded(receiveTime, decodeTime);
+        rowReceived[row] = receiveTime;
+        rowDecoded[row] = decodeTime;
+
+        if (!history)
+            return;
+        historyRow.assign(image.row(row), image.row(row) + image.bins);
+        lock.unlock();
+        history->addSpoke(radarAzimuthToDegrees(spoke.azimuth), receiveTime, historyRow.data(), (int)historyRow.size());
+    }
 };
+VideoState video;
+
+// created once on the first context, used by every window through the share group
+struct SharedGL
+{
+    GLuint program = 0;
+    GLsync ready = nullptr;
+};
+SharedGL sharedGL;
 
 void processInput(GLFWwindow *window);
 
+// collects the traced rows just uploaded into the frame, video.mutex held
+static void traceUploadedRows(RadarLatencyTracker::Frame &frame, float fromDegrees, float toDegrees)
+{
+    int first, count;
+    video.image.sweptRows(fromDegrees, toDegrees, first, count);
+    int64_t uploadTime = RadarLatencyTracker::now();
+    frame.uploadTime = uploadTime;
+    frame.receiveTimes.clear();
+    for (int k = 0; k < count; k++)
+    {
+        int row = (first + k) % video.image.azimuths;
+        if (video.rowReceived[row] == 0)
+            continue;
+        RadarLatencyTracker::shared().record(RADAR_LATENCY_UPLOAD, uploadTime - video.rowDecoded[row]);
+        frame.receiveTimes.push_back(video.rowReceived[row]);
+        video.rowReceived[row] = 0;
+    }
+}
+
+// after the radar window's swap, the frame's spokes are traced until the GPU has finished it
+void presentRadar(void *userData)
+{
+    static RadarPresentProbe probe;
+    auto *state = static_cast<RadarState *>(userData);
+    probe.submit(std::move(state->latencyFrame));
+    state->latencyFrame = RadarLatencyTracker::Frame();
+}
+
 void drawRadar(void *userData)
 {
     if (glGetError() != GL_NO_ERROR)
@@ -22,17 +181,89 @@ void drawRadar(void *userData)
 
     auto *state = static_cast<RadarState *>(userData);
     static RadarGeometry geo(0.0f, 0.0f, 60.0f);
-    static RadarRenderer gridRenderer, sweepRenderer;
+    static RadarRenderer gridRenderer(sharedGL.program), sweepRenderer(sharedGL.program), detectionRenderer(sharedGL.program);
+    static RadarVideoRenderer videoRenderer;
+    static RadarGridLabels gridLabels(5.0f);
+
+    // angle comes from the clock, not from summing frame times
+    state->clock.sync();
+    state->sweepAngle = state->clock.angle();
 
-    if (gridRenderer.getVertexCount() == 0)
+    // first frame, on the radar window's thread with its context current
+    if (!state->drawingSetUp)
+    {
+        // keeps the converted video between frames
+        videoRenderer.setCartesianCache(true);
+        state->sweptFrom[0] = state->sweptFrom[1] = state->sweepAngle;
+        state->drawingSetUp = true;
+    }
+
+    // the grid and video are clipped to the sector, the sweep still follows the antenna
+    bool sectorChanged = state->sectorChanged;
+    if (sectorChanged)
+    {
+        geo.setSector(state->sectorStart, state->sectorEnd, false);
+        videoRenderer.setSector(geo);
+        state->sectorChanged = false;
+    }
+
+    // labels are part of the grid buffer, rebuilt only when the window leaves its zoom bucket
+    GLint vp[4];
+    glGetIntegerv(GL_VIEWPORT, vp);
+    if (sectorChanged || gridRenderer.getVertexCount() == 0 || !gridLabels.isCurrent(5, 12, vp[2], vp[3], geo.getGridColor()))
     {
         auto gridVert = geo.generateGrid(5, 12);
+        const auto &labelVert = gridLabels.build(5, 12, vp[2], vp[3], geo.getGridColor());
+        gridVert.insert(gridVert.end(), labelVert.begin(), labelVert.end());
         gridRenderer.upload(gridVert);
     }
 
     auto sweepvert = geo.generateStoppedSweep(state->sweepAngle);
     sweepRenderer.upload(sweepvert);
 
+    // the sweep follows the antenna, so only the rows it crossed since the
+    // previous frame can have changed; the interval starts a frame further
+    // back so a spoke received just after the sweep passed its row still shows
+    float *sweptFrom = state->sweptFrom;
+
+    // a scrubbed revolution replaces the video until the operator returns to live
+    int scrub = state->scrubBack.load(std::memory_order_relaxed);
+    if (scrub != state->shownScrub && video.history)
+    {
+        int64_t moment = scrub > 0 ? video.history->getRevolutionStart(scrub) : 0;
+        if (scrub == 0)
+        {
+            std::lock_guard<std::mutex> lock(video.mutex);
+            videoRenderer.upload(video.image, &video.pyramid);
+        }
+        else if (moment != 0 && video.history->reconstruct(moment, state->scrubImage))
+            videoRenderer.upload(state->scrubImage);
+        state->shownScrub = scrub;
+    }
+    bool live = state->shownScrub == 0;
+
+    {
+        std::lock_guard<std::mutex> lock(video.mutex);
+        if (live)
+        {
+            videoRenderer.uploadSwept(video.image, sweptFrom[0], state->sweepAngle, &video.pyramid);
+            traceUploadedRows(state->latencyFrame, sweptFrom[0], state->sweepAngle);
+        }
+        sweptFrom[0] = sweptFrom[1];
+        sweptFrom[1] = state->sweepAngle;
+        if (video.dirty)
+        {
+            std::vector<RadarDetection> detections;
+            for (const auto &row : video.rowDetections)
+                detections.insert(detections.end(), row.begin(), row.end());
+            detectionRenderer.upload(geo.generateDetections(detections, video.image.azimuths, video.image.bins));
+            video.dirty = false;
+        }
+    }
+
+    videoRenderer.render();
+    if (live)
+        detectionRenderer.render(GL_POINTS);
     gridRenderer.render(GL_LINES);
     sweepRenderer.render(GL_TRIANGLE_FAN);
     GLenum err = glGetError();
@@ -42,20 +273,8 @@ void drawRadar(void *userData)
 
 void drawText(void *data)
 {
-    static std::vector<std::string> displayLines;
-    static std::mutex displayMutex;
     static TextVertex textBuilder;
-    static RadarRenderer renderer;
-
-    // Pull messages from UDP listener
-    std::string msg;
-    while (listener.popMessage(msg))
-    {
-        std::lock_guard<std::mutex> lock(displayMutex);
-        displayLines.push_back(msg);
-        if (displayLines.size() > 20)
-            displayLines.erase(displayLines.begin());
-    }
+    static RadarRenderer renderer(sharedGL.program);
 
     GLint vp[4];
     glGetIntegerv(GL_VIEWPORT, vp);
@@ -66,9 +285,40 @@ void drawText(void *data)
     float x = 10.0f, y = 20.0f;
     float scale = 2.0f;
     const float lineSpacing = 15.0f;
+    for (int source = 0; source < listener.getSourceCount(); source++)
     {
-        std::lock_guard<std::mutex> lock(displayMutex);
-        for (const auto &line : displayLines)
+        uint64_t spokes = info.spokeCounts[source].load(std::memory_order_relaxed);
+        uint64_t dropped = listener.getDropped(source);
+        if (spokes == 0 && dropped == 0)
+            continue;
+        std::string line = "spokes: " + std::to_string(spokes);
+        if (listener.getSourceCount() > 1)
+            line = "source " + std::to_string(source) + (source == shownSource ? "*" : "") + " " + line;
+        if (dropped > 0)
+            line += ", dropped " + std::to_string(dropped);
+        auto countVerts = textBuilder.build(line, x, y, screenW, screenH, Vec4(0, 1, 0, 1), scale);
+        vertices.insert(vertices.end(), countVerts.begin(), countVerts.end());
+        y += lineSpacing;
+    }
+
+    if (latencyOverlay)
+    {
+        static const char *stageNames[RADAR_LATENCY_STAGES] = {"decode", "upload", "present", "total"};
+        for (int stage = 0; stage < RADAR_LATENCY_STAGES; stage++)
+        {
+            auto s = RadarLatencyTracker::shared().getStage((RadarLatencyStage)stage).summarize();
+            char line[128];
+            snprintf(line, sizeof(line), "%-8s p50 %.2f p95 %.2f p99 %.2f max %.2f ms", stageNames[stage],
+                     s.p50Ms, s.p95Ms, s.p99Ms, s.maxMs);
+            auto lineVerts = textBuilder.build(line, x, y, screenW, screenH, Vec4(1, 1, 0, 1), scale);
+            vertices.insert(vertices.end(), lineVerts.begin(), lineVerts.end());
+            y += lineSpacing;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(info.mutex);
+        for (const auto &line : info.lines)
         {
             auto lineVerts = textBuilder.build(line, x, y, screenW, screenH, Vec4(1, 1, 1, 1), scale);
             vertices.insert(vertices.end(), lineVerts.begin(), lineVerts.end());
@@ -137,8 +387,86 @@ void drawSquare(void *data)
     glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
 }
 
-int main()
+// --source <spec>  receive on [address:]port[@interface], repeatable, one
+//                  source id each (0, 1, ...); an IPv4 or IPv6 ([addr]:port)
+//                  multicast address joins the group; default port 5555
+// --radar <id>     source shown in the radar window, default the first
+//                  (the replay when replaying)
+// --sector <start>:<end>  show only the arc from start counter-clockwise to end (degrees)
+// --record <file>  append every received packet to a recording
+// --replay <file>  feed a recording into the pipeline
+// --speed <x>      replay speed, 1 is real time, 0 as fast as possible
+// --latency-overlay  show per-stage video latency in the info window
+// --history-spill <file>  spill the scrubbing history past its memory budget
+//                  to this file instead of dropping the oldest revolutions
+int main(int argc, char **argv)
 {
+    RadarState radarState;
+    std::string recordPath, replayPath, historySpill;
+    double replaySpeed = 1.0;
+    int radarSource = -1;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--latency-overlay")
+        {
+            latencyOverlay = true;
+            continue;
+        }
+        // every other option takes a value
+        if (i + 1 >= argc)
+        {
+            std::cerr << "Missing value for " << arg << "\n";
+            break;
+        }
+
+        if (arg == "--source")
+        {
+            UdpSource source;
+            if (UdpListener::parseSource(argv[i + 1], source))
+                listener.addSource(source);
+            else
+                std::cerr << "Bad source " << argv[i + 1] << "\n";
+        }
+        else if (arg == "--radar")
+            radarSource = atoi(argv[i + 1]);
+        else if (arg == "--sector")
+        {
+            float start, end;
+            if (sscanf(argv[i + 1], "%f:%f", &start, &end) == 2)
+            {
+                radarState.sectorStart = start;
+                radarState.sectorEnd = end;
+                radarState.sectorChanged = true;
+            }
+            else
+                std::cerr << "Bad sector " << argv[i + 1] << "\n";
+        }
+        else if (arg == "--record")
+            recordPath = argv[i + 1];
+        else if (arg == "--replay")
+            replayPath = argv[i + 1];
+        else if (arg == "--speed")
+            replaySpeed = atof(argv[i + 1]);
+        else if (arg == "--history-spill")
+            historySpill = argv[i + 1];
+        else
+            std::cerr << "Unknown argument " << arg << "\n";
+        i++;
+    }
+
+    if (listener.getSourceCount() == 0)
+        listener.addSource(UdpSource());
+    // replayed packets get their own queue, the listener thread never writes it
+    int replaySource = -1;
+    if (!replayPath.empty())
+    {
+        UdpSource injected;
+        injected.port = 0;
+        replaySource = listener.addSource(injected);
+    }
+    shownSource = radarSource >= 0 ? radarSource : (replaySource >= 0 ? replaySource : 0);
+
     if (!glfwInit())
     {
         std::cerr << "[GLFW] Initialization failed!\n";
@@ -150,40 +478,136 @@ int main()
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
-    // Create both windows in main thread
+    // Create both windows in main thread, only the radar window waits for vsync
     Window radWin("Radar Window");
     radWin.init();
     Window infoWin("Info Window", 600, 600, 0.1f, 0.1f, 0.1f, 1.0f);
-    infoWin.init(radWin.getHandle());
-
-    RadarState radarState;
-    double lastTime = glfwGetTime();
+    infoWin.init(radWin.getHandle(), 0);
+
+    // shared program, fenced so the other contexts wait until it is really created
+    glfwMakeContextCurrent(radWin.getHandle());
+    sharedGL.program = RadarRenderer::createProgram();
+    sharedGL.ready = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glFlush();
+    glfwMakeContextCurrent(nullptr);
+
+    // the shown radar's last 10 minutes, Left / Right step a revolution back /
+    // forward, End returns to the live video
+    RadarSpokeHistory::Config historyConfig;
+    historyConfig.azimuths = video.processor.getConfig().azimuths;
+    historyConfig.bins = video.processor.getConfig().bins;
+    historyConfig.spillPath = historySpill;
+    RadarSpokeHistory history(historyConfig);
+    video.history = &history;
+    radWin.setKeyCallback([&radWin, &radarState, &history](int key)
+                          {
+        int back = radarState.scrubBack.load();
+        int newest = (int)history.getRevolutionCount() - 1;
+        if (key == GLFW_KEY_LEFT)
+            back = std::min(back + 1, std::max(newest, 0));
+        else if (key == GLFW_KEY_RIGHT)
+            back = std::max(back - 1, 0);
+        else if (key == GLFW_KEY_END)
+            back = 0;
+        else
+            return;
+        radarState.scrubBack.store(back);
+        radWin.requestRedraw(); });
 
     radWin.setRenderCallback(drawRadar, &radarState);
+    radWin.setSwapCallback(presentRadar);
     infoWin.setRenderCallback(drawText);
 
+    // every source is drained on its own thread as packets arrive; the shown
+    // radar's spokes lock the sweep to the antenna and are decoded there, the
+    // others are only counted, anything else is shown in the info window
+    radarState.clock.setPhaseLock(true);
+    info.spokeCounts = std::vector<std::atomic<uint64_t>>(listener.getSourceCount());
+    for (int source = 0; source < listener.getSourceCount(); source++)
+    {
+        listener.setConsumer(source, [source, &infoWin, &radarState](const char *data, size_t size, int64_t receiveTime)
+                             {
+            RadarSpokeHeader spoke;
+            if (const uint8_t *payload = radarParseSpoke(data, size, spoke))
+            {
+                info.spokeCounts[source].fetch_add(1, std::memory_order_relaxed);
+                if (source != shownSource)
+                    return;
+                radarState.clock.reportAzimuth(radarAzimuthToDegrees(spoke.azimuth));
+                radarState.spokeArrived();
+                video.addSpoke(spoke, payload, receiveTime);
+                return;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(info.mutex);
+                info.lines.emplace_back(data, size);
+                if (info.lines.size() > 20)
+                    info.lines.erase(info.lines.begin());
+            }
+            infoWin.requestRedraw(); });
+    }
+
+    RadarRecorder recorder;
+    if (!recordPath.empty() && recorder.open(recordPath))
+        listener.setRecorder(&recorder);
     listener.start();
 
+    RadarReplay replay;
+    std::thread replayThread;
+    if (!replayPath.empty() && replay.open(replayPath))
+    {
+        std::cout << "[Replay] " << replay.getPacketCount() << " packets from " << replayPath << "\n";
+        replayThread = std::thread([&replay, &infoWin, replaySpeed, replaySource]()
+                                   {
+            replay.play([replaySource](const RadarPacketView &packet)
+                        { listener.injectPacket(replaySource, (const char *)packet.data, packet.size, packet.timestamp); },
+                        replaySpeed);
+            infoWin.requestRedraw(); });
+    }
+
+    // each window renders and swaps on its own thread, main thread only handles
+    // events and switches the radar window between animating and idle
+    bool radarContinuous = false, infoContinuous = false;
+    radWin.startRenderThread(sharedGL.ready);
+    infoWin.startRenderThread(sharedGL.ready);
+
     while (!glfwWindowShouldClose(radWin.getHandle()) ||
            !glfwWindowShouldClose(infoWin.getHandle()))
     {
-        double now = glfwGetTime();
-        double dt = now - lastTime;
-        lastTime = now;
+        bool active = radarState.sweepActive();
+        if (active != radarContinuous)
+        {
+            radWin.setContinuous(active);
+            radarContinuous = active;
+        }
+        // spoke counts and the overlay change without new messages, a few
+        // updates a second are enough
+        if ((active || latencyOverlay) != infoContinuous)
+        {
+            infoContinuous = active || latencyOverlay;
+            infoWin.setContinuous(infoContinuous, 4.0);
+        }
+        // a new spoke posts an empty event, the timeout notices the antenna stopping
+        if (active)
+            glfwWaitEventsTimeout(0.5);
+        else
+            glfwWaitEvents();
+    }
 
-        // animating 60 degree per second
-        radarState.sweepAngle -= 60.0f * dt;
-        if (radarState.sweepAngle < 0.0f)
-            radarState.sweepAngle += 360.0f;
+    radWin.stopRenderThread();
+    infoWin.stopRenderThread();
 
-        radWin.renderOnce();
-        infoWin.renderOnce();
-        glfwPollEvents();
+    glfwMakeContextCurrent(radWin.getHandle());
+    glDeleteSync(sharedGL.ready);
+    glDeleteProgram(sharedGL.program);
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
-    }
+    replay.stop();
+    if (replayThread.joinable())
+        replayThread.join();
 
     listener.stop();
+    recorder.close();
 
     glfwTerminate();
     return 0;
@@ -1,6 +1,12 @@
 #include "udp_listener.h"
+#include "RadarPacketRing.h"
+#include "RadarRecorder.h"
+#include "RadarSpoke.h"
 #include <iostream>
 #include <cstring>
+#include <cstdlib>
+#include <chrono>
+#include <atomic>
 
 #ifdef _WIN32
 #include <winsock2.h>
@@ -8,11 +14,37 @@
 #pragma comment(lib, "ws2_32.lib")
 #else
 #include <sys/socket.h>
+#include <sys/ioctl.h>
+#include <sys/epoll.h>
 #include <arpa/inet.h>
+#include <netinet/in.h>
+#include <net/if.h>
 #include <unistd.h>
+#include <cerrno>
+typedef int SOCKET;
+typedef unsigned long u_long;
+#define INVALID_SOCKET (-1)
+#define SOCKET_ERROR (-1)
+#define closesocket close
+#define ioctlsocket ioctl
+#define WSAGetLastError() errno
+#define WSAEWOULDBLOCK EWOULDBLOCK
 #endif
 
-UdpListener::UdpListener(int port) : port(port)
+// largest UDP payload
+static const int MAX_PACKET_SIZE = 65536;
+// packets taken from a ready socket per wakeup, other sources get their turn in between
+static const int RECEIVE_BATCH = 16;
+// wake up periodically so stop() does not wait for the next packet
+static const int POLL_TIMEOUT_MS = 200;
+
+static int64_t wallClockNanos()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+UdpListener::UdpListener()
 {
 #ifdef _WIN32
     WSADATA wsaData;
@@ -28,11 +60,64 @@ UdpListener::~UdpListener()
 #endif
 }
 
+int UdpListener::addSource(const UdpSource &source)
+{
+    Source s;
+    s.config = source;
+    s.queue.reset(new RadarPacketRing(source.queueBytes));
+    sources.push_back(std::move(s));
+    return (int)sources.size() - 1;
+}
+
+bool UdpListener::parseSource(const std::string &spec, UdpSource &out)
+{
+    std::string endpoint = spec;
+    out = UdpSource();
+    size_t at = endpoint.find('@');
+    if (at != std::string::npos)
+    {
+        out.interfaceName = endpoint.substr(at + 1);
+        endpoint.resize(at);
+    }
+
+    std::string port = endpoint;
+    if (!endpoint.empty() && endpoint[0] == '[')
+    {
+        size_t close = endpoint.find("]:");
+        if (close == std::string::npos)
+            return false;
+        out.address = endpoint.substr(1, close - 1);
+        port = endpoint.substr(close + 2);
+    }
+    else if (endpoint.find(':') != std::string::npos)
+    {
+        size_t colon = endpoint.find(':');
+        out.address = endpoint.substr(0, colon);
+        port = endpoint.substr(colon + 1);
+    }
+
+    char *end = nullptr;
+    long value = strtol(port.c_str(), &end, 10);
+    if (port.empty() || *end != '\0' || value <= 0 || value > 65535)
+        return false;
+    out.port = (int)value;
+    return true;
+}
+
+void UdpListener::setConsumer(int source, std::function<void(const char *data, size_t size, int64_t receiveTime)> consumer)
+{
+    sources[source].consumer.reset(new Consumer());
+    sources[source].consumer->callback = consumer;
+}
+
 void UdpListener::start()
 {
     if (running)
         return;
     running = true;
+    for (int id = 0; id < (int)sources.size(); id++)
+        if (sources[id].consumer)
+            sources[id].consumer->thread = std::thread(&UdpListener::consumeLoop, this, id);
     listenThread = std::thread(&UdpListener::listenLoop, this);
 }
 
@@ -41,90 +126,366 @@ void UdpListener::stop()
     running = false;
     if (listenThread.joinable())
         listenThread.join();
+    for (Source &source : sources)
+    {
+        if (!source.consumer)
+            continue;
+        {
+            std::lock_guard<std::mutex> lock(source.consumer->mutex);
+            source.consumer->wake.notify_one();
+        }
+        if (source.consumer->thread.joinable())
+            source.consumer->thread.join();
+    }
+}
+
+void UdpListener::injectPacket(int source, const char *data, size_t size, int64_t timestamp)
+{
+    deliver(source, data, size, timestamp, false);
+}
+
+void UdpListener::deliver(int source, const char *data, size_t size, int64_t timestamp, bool record)
+{
+    if (record && recorder)
+        recorder->write(data, (uint32_t)size, timestamp);
+
+    // a replayed packet's timestamp is from the recording, its latency starts now
+    if (!sources[source].queue->push(data, size, record ? timestamp : wallClockNanos()))
+        return;
+
+    // pairs with the fence in consumeLoop: either the consumer sees the
+    // packet before it sleeps, or we see it waiting
+    Consumer *consumer = sources[source].consumer.get();
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (consumer && consumer->waiting.load(std::memory_order_relaxed))
+    {
+        std::lock_guard<std::mutex> lock(consumer->mutex);
+        consumer->wake.notify_one();
+    }
+}
+
+void UdpListener::consumeLoop(int source)
+{
+    RadarPacketRing &queue = *sources[source].queue;
+    Consumer &consumer = *sources[source].consumer;
+    while (running)
+    {
+        size_t size;
+        int64_t receiveTime;
+        if (const uint8_t *data = queue.front(size, receiveTime))
+        {
+            consumer.callback((const char *)data, size, receiveTime);
+            queue.pop();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(consumer.mutex);
+        consumer.waiting.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!queue.front(size, receiveTime) && running)
+            consumer.wake.wait_for(lock, std::chrono::milliseconds(POLL_TIMEOUT_MS));
+        consumer.waiting.store(false, std::memory_order_relaxed);
+    }
+}
+
+bool UdpListener::popMessage(int source, std::string &outMessage)
+{
+    return sources[source].queue->pop(outMessage);
 }
 
 bool UdpListener::popMessage(std::string &outMessage)
 {
-    std::lock_guard<std::mutex> lock(queueMutex);
-    if (msgQueue.empty())
-        return false;
-    outMessage = std::move(msgQueue.front());
-    msgQueue.pop_front();
-    return true;
+    int count = (int)sources.size();
+    for (int k = 0; k < count; k++)
+    {
+        int source = (nextPop + k) % count;
+        if (sources[source].queue->pop(outMessage))
+        {
+            nextPop = (source + 1) % count;
+            return true;
+        }
+    }
+    return false;
 }
 
-void UdpListener::listenLoop()
+uint64_t UdpListener::getDropped(int source) const
+{
+    return sources[source].queue->getDropped();
+}
+
+static unsigned int interfaceIndex(const std::string &name)
 {
-    SOCKET sockfd;
-    struct sockaddr_in addr;
-    char buffer[2048];
+    if (name.empty())
+        return 0;
+    char *end = nullptr;
+    unsigned long index = strtoul(name.c_str(), &end, 10);
+    if (*end == '\0')
+        return (unsigned int)index;
+#ifdef _WIN32
+    return 0;
+#else
+    return if_nametoindex(name.c_str());
+#endif
+}
+
+bool UdpListener::openSource(Source &source)
+{
+    const UdpSource &c = source.config;
+    bool v6 = c.address.find(':') != std::string::npos;
+    std::string label = (v6 ? "[" + c.address + "]" : c.address) + ":" + std::to_string(c.port);
+
+    sockaddr_storage bindAddr{};
+    socklen_t bindLen;
+    bool multicast = false;
+    if (v6)
+    {
+        sockaddr_in6 *a = (sockaddr_in6 *)&bindAddr;
+        a->sin6_family = AF_INET6;
+        a->sin6_port = htons((uint16_t)c.port);
+        if (inet_pton(AF_INET6, c.address.c_str(), &a->sin6_addr) != 1)
+        {
+            std::cerr << "[UDP] Bad address " << c.address << "\n";
+            return false;
+        }
+        multicast = IN6_IS_ADDR_MULTICAST(&a->sin6_addr);
+        bindLen = sizeof(sockaddr_in6);
+    }
+    else
+    {
+        sockaddr_in *a = (sockaddr_in *)&bindAddr;
+        a->sin_family = AF_INET;
+        a->sin_port = htons((uint16_t)c.port);
+        a->sin_addr.s_addr = INADDR_ANY;
+        if (!c.address.empty() && inet_pton(AF_INET, c.address.c_str(), &a->sin_addr) != 1)
+        {
+            std::cerr << "[UDP] Bad address " << c.address << "\n";
+            return false;
+        }
+        multicast = (ntohl(a->sin_addr.s_addr) & 0xF0000000u) == 0xE0000000u;
+        bindLen = sizeof(sockaddr_in);
+    }
 
-    sockfd = socket(AF_INET, SOCK_DGRAM, 0);
+    unsigned int ifindex = interfaceIndex(c.interfaceName);
+    if (!c.interfaceName.empty() && ifindex == 0)
+    {
+        std::cerr << "[UDP] Unknown interface " << c.interfaceName << "\n";
+        return false;
+    }
+
+    SOCKET sockfd = socket(v6 ? AF_INET6 : AF_INET, SOCK_DGRAM, 0);
     if (sockfd == INVALID_SOCKET)
     {
-        std::cerr << "[UDP] Failed to create socket\n";
-        return;
+        std::cerr << "[UDP] Failed to create socket for " << label << "\n";
+        return false;
     }
 
-    // Force blocking mode
-    u_long mode = 0;
-    ioctlsocket(sockfd, FIONBIO, &mode);
+    // several sources (or processes) may receive groups on the same port
+    int on = 1;
+    setsockopt(sockfd, SOL_SOCKET, SO_REUSEADDR, (const char *)&on, sizeof(on));
+    if (v6)
+        setsockopt(sockfd, IPPROTO_IPV6, IPV6_V6ONLY, (const char *)&on, sizeof(on));
 
-    // Allow rebinding even if the port is still in TIME_WAIT
-    int reuse = 1;
-    setsockopt(sockfd, SOL_SOCKET, SO_REUSEADDR, (const char *)&reuse, sizeof(reuse));
+    // a revolution of spokes can arrive faster than one wakeup
+    int receiveBuffer = 8 << 20;
+    setsockopt(sockfd, SOL_SOCKET, SO_RCVBUF, (const char *)&receiveBuffer, sizeof(receiveBuffer));
 
-    addr.sin_family = AF_INET;
-    addr.sin_addr.s_addr = INADDR_ANY;
-    addr.sin_port = htons(port);
+    u_long nonBlocking = 1;
+    ioctlsocket(sockfd, FIONBIO, &nonBlocking);
+
+#ifdef _WIN32
+    // Windows binds multicast receivers to the wildcard address
+    if (multicast)
+    {
+        if (v6)
+            ((sockaddr_in6 *)&bindAddr)->sin6_addr = in6addr_any;
+        else
+            ((sockaddr_in *)&bindAddr)->sin_addr.s_addr = INADDR_ANY;
+    }
+#else
+    // Kernel receive timestamps for recordings and latency tracing
+    setsockopt(sockfd, SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on));
+#endif
 
-    if (bind(sockfd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+    // elsewhere a multicast socket is bound to its group, so sources sharing
+    // a port only get their own group's packets
+    if (bind(sockfd, (sockaddr *)&bindAddr, bindLen) < 0)
     {
-        std::cerr << "[UDP] Bind failed on port " << port << "\n";
+        std::cerr << "[UDP] Bind failed on " << label << "\n";
         closesocket(sockfd);
+        return false;
+    }
+
+    if (multicast)
+    {
+        int result;
+        if (v6)
+        {
+            ipv6_mreq m{};
+            inet_pton(AF_INET6, c.address.c_str(), &m.ipv6mr_multiaddr);
+            m.ipv6mr_interface = ifindex;
+            result = setsockopt(sockfd, IPPROTO_IPV6, IPV6_JOIN_GROUP, (const char *)&m, sizeof(m));
+        }
+        else
+        {
+#ifdef _WIN32
+            // an address in 0.0.0.0/8 selects the interface by index
+            ip_mreq m{};
+            inet_pton(AF_INET, c.address.c_str(), &m.imr_multiaddr);
+            m.imr_interface.s_addr = htonl(ifindex);
+#else
+            ip_mreqn m{};
+            inet_pton(AF_INET, c.address.c_str(), &m.imr_multiaddr);
+            m.imr_ifindex = (int)ifindex;
+#endif
+            result = setsockopt(sockfd, IPPROTO_IP, IP_ADD_MEMBERSHIP, (const char *)&m, sizeof(m));
+        }
+        if (result < 0)
+        {
+            std::cerr << "[UDP] Joining " << label << " failed: " << WSAGetLastError() << "\n";
+            closesocket(sockfd);
+            return false;
+        }
+    }
+
+    source.socket = (intptr_t)sockfd;
+    std::cout << "[UDP] " << (multicast ? "Joined " : "Listening on ") << label
+              << (c.interfaceName.empty() ? "" : " on " + c.interfaceName) << "...\n";
+    return true;
+}
+
+void UdpListener::closeSources()
+{
+    for (Source &source : sources)
+    {
+        if (source.socket != -1)
+            closesocket((SOCKET)source.socket);
+        source.socket = -1;
+    }
+}
+
+void UdpListener::listenLoop()
+{
+    int opened = 0;
+    for (Source &source : sources)
+        opened += source.config.port != 0 && openSource(source);
+    if (opened == 0)
+    {
+        closeSources();
         return;
     }
 
-    std::cout << "[UDP] Listening on port " << port << "...\n";
+    // the batch buffers are reused for every source
+    std::vector<char> buffer((size_t)MAX_PACKET_SIZE * RECEIVE_BATCH);
+    auto dispatch = [&](int source, const char *data, int len, int64_t timestamp)
+    {
+        // no kernel timestamp on this platform, take it as early as possible
+        if (timestamp == 0)
+            timestamp = wallClockNanos();
+
+        deliver(source, data, len, timestamp, true);
 
-    sockaddr_in senderAddr{};
-    socklen_t addrLen = sizeof(senderAddr);
+        RadarSpokeHeader spoke;
+        if (!radarParseSpoke(data, len, spoke))
+            std::cout << "[UDP] Received: " << std::string(data, len) << "\n";
+    };
 
+#ifdef _WIN32
     while (running)
     {
-        int len = recvfrom(sockfd, buffer, sizeof(buffer) - 1, 0,
-                           (struct sockaddr *)&senderAddr, &addrLen);
+        fd_set ready;
+        FD_ZERO(&ready);
+        for (const Source &source : sources)
+            if (source.socket != -1)
+                FD_SET((SOCKET)source.socket, &ready);
+
+        timeval timeout = {0, POLL_TIMEOUT_MS * 1000};
+        if (select(0, &ready, nullptr, nullptr, &timeout) <= 0)
+            continue;
 
-        if (len == SOCKET_ERROR)
+        for (int id = 0; id < (int)sources.size(); id++)
         {
-            int err = WSAGetLastError();
-            if (err == WSAEWOULDBLOCK || err == WSAETIMEDOUT)
+            SOCKET sockfd = (SOCKET)sources[id].socket;
+            if (sources[id].socket == -1 || !FD_ISSET(sockfd, &ready))
                 continue;
-            if (!running)
-                break;
-            std::cerr << "[UDP] recvfrom() error: " << err << "\n";
-            break;
+            for (int k = 0; k < RECEIVE_BATCH; k++)
+            {
+                int len = recv(sockfd, buffer.data(), MAX_PACKET_SIZE, 0);
+                if (len <= 0)
+                    break;
+                dispatch(id, buffer.data(), len, 0);
+            }
         }
+    }
+#else
+    int epollfd = epoll_create1(0);
+    for (int id = 0; id < (int)sources.size(); id++)
+    {
+        if (sources[id].socket == -1)
+            continue;
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u32 = (uint32_t)id;
+        epoll_ctl(epollfd, EPOLL_CTL_ADD, (int)sources[id].socket, &event);
+    }
 
-        std::cout << "[UDP DEBUG] recvfrom() returned len=" << len
-                  << " err=" << WSAGetLastError() << "\n";
+    // one recvmmsg call takes a batch, each packet with its own timestamp
+    mmsghdr msgs[RECEIVE_BATCH];
+    iovec iovs[RECEIVE_BATCH];
+    char control[RECEIVE_BATCH][CMSG_SPACE(sizeof(timespec))];
+    epoll_event events[RECEIVE_BATCH];
 
-        if (len > 0)
+    while (running)
+    {
+        int ready = epoll_wait(epollfd, events, RECEIVE_BATCH, POLL_TIMEOUT_MS);
+        if (ready < 0 && errno != EINTR)
         {
-            buffer[len] = '\0';
-            std::string msg(buffer);
+            std::cerr << "[UDP] epoll_wait() error: " << errno << "\n";
+            break;
+        }
 
+        // level triggered, a socket with more than a batch waiting comes back next round
+        for (int e = 0; e < ready; e++)
+        {
+            int id = (int)events[e].data.u32;
+            for (int k = 0; k < RECEIVE_BATCH; k++)
+            {
+                iovs[k] = {buffer.data() + (size_t)k * MAX_PACKET_SIZE, (size_t)MAX_PACKET_SIZE};
+                msgs[k] = {};
+                msgs[k].msg_hdr.msg_iov = &iovs[k];
+                msgs[k].msg_hdr.msg_iovlen = 1;
+                msgs[k].msg_hdr.msg_control = control[k];
+                msgs[k].msg_hdr.msg_controllen = sizeof(control[k]);
+            }
+
+            int count = recvmmsg((int)sources[id].socket, msgs, RECEIVE_BATCH, MSG_DONTWAIT, nullptr);
+            if (count < 0)
             {
-                std::lock_guard<std::mutex> lock(queueMutex);
-                msgQueue.push_back(msg);
-                if (msgQueue.size() > 100)
-                    msgQueue.pop_front();
+                if (errno != EWOULDBLOCK && errno != EAGAIN && errno != EINTR)
+                    std::cerr << "[UDP] recvmmsg() error: " << errno << "\n";
+                continue;
             }
 
-            std::cout << "[UDP] Received: " << msg << "\n";
+            for (int k = 0; k < count; k++)
+            {
+                int64_t timestamp = 0;
+                msghdr &msg = msgs[k].msg_hdr;
+                for (cmsghdr *c = CMSG_FIRSTHDR(&msg); c; c = CMSG_NXTHDR(&msg, c))
+                {
+                    if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SCM_TIMESTAMPNS)
+                    {
+                        timespec ts;
+                        memcpy(&ts, CMSG_DATA(c), sizeof(ts));
+                        timestamp = (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+                    }
+                }
+                if (msgs[k].msg_len > 0)
+                    dispatch(id, (const char *)iovs[k].iov_base, (int)msgs[k].msg_len, timestamp);
+            }
         }
     }
+    close(epollfd);
+#endif
 
-    closesocket(sockfd);
+    closeSources();
     std::cout << "[UDP] Listener stopped.\n";
 }
@@ -1,10 +1,16 @@
 #include "Window.h"
+#include "frame_pacer.h"
+
+// upper bound for waiting on the previous frame's fence
+static const GLuint64 FRAME_FENCE_TIMEOUT_NS = 100000000;
 
 Window::Window(const std::string &title, int width, int height, float r, float g, float b, float a)
     : title(title), width(width), height(height), r(r), g(g), b(b), a(a) {}
 
 Window::~Window()
 {
+    stopRenderThread();
+
     if (window)
     {
         glfwDestroyWindow(window);
@@ -12,8 +18,10 @@ Window::~Window()
     }
 }
 
-bool Window::init(GLFWwindow *share)
+bool Window::init(GLFWwindow *share, int swapInterval)
 {
+    this->swapInterval = swapInterval;
+
     window = glfwCreateWindow(width, height, title.c_str(), nullptr, share);
     if (!window)
     {
@@ -25,6 +33,7 @@ bool Window::init(GLFWwindow *share)
     }
 
     glfwMakeContextCurrent(window);
+    glfwSwapInterval(swapInterval);
     glewExperimental = GL_TRUE;
     GLenum err = glewInit();
     if (err != GLEW_OK)
@@ -38,18 +47,153 @@ bool Window::init(GLFWwindow *share)
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    int fbWidth, fbHeight;
-    glfwGetFramebufferSize(window, &fbWidth, &fbHeight);
-    glViewport(0, 0, fbWidth, fbHeight);
-    std::cout << "[GLFW] Framebuffer size for " << title << ": " << fbWidth << "x" << fbHeight << "\n";
+    int w, h;
+    glfwGetFramebufferSize(window, &w, &h);
+    fbWidth = w;
+    fbHeight = h;
+    glViewport(0, 0, w, h);
+    std::cout << "[GLFW] Framebuffer size for " << title << ": " << w << "x" << h << "\n";
+
+    // resize and expose events mark the window for redraw
+    glfwSetWindowUserPointer(window, this);
+    glfwSetFramebufferSizeCallback(window, onFramebufferSize);
+    glfwSetWindowRefreshCallback(window, onRefresh);
+    glfwSetKeyCallback(window, onKey);
 
     return true;
 }
 
-void Window::renderOnce()
+void Window::onFramebufferSize(GLFWwindow *handle, int width, int height)
+{
+    auto *self = static_cast<Window *>(glfwGetWindowUserPointer(handle));
+    self->fbWidth = width;
+    self->fbHeight = height;
+    self->requestRedraw();
+}
+
+void Window::onRefresh(GLFWwindow *handle)
+{
+    static_cast<Window *>(glfwGetWindowUserPointer(handle))->requestRedraw();
+}
+
+void Window::onKey(GLFWwindow *handle, int key, int, int action, int)
+{
+    auto *self = static_cast<Window *>(glfwGetWindowUserPointer(handle));
+    if (action != GLFW_RELEASE && self->keyCallback)
+        self->keyCallback(key);
+}
+
+void Window::requestRedraw()
+{
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        dirty.store(true, std::memory_order_release);
+    }
+    wake.notify_one();
+}
+
+void Window::setContinuous(bool enabled, double targetFps)
+{
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        continuous = enabled;
+        this->targetFps = targetFps;
+    }
+    wake.notify_one();
+}
+
+void Window::startRenderThread(GLsync sharedReady)
+{
+    std::lock_guard<std::mutex> lock(stateMutex);
+    if (running)
+        return;
+
+    running = true;
+    renderThread = std::thread(&Window::renderLoop, this, sharedReady);
+}
+
+void Window::stopRenderThread()
+{
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        running = false;
+    }
+    wake.notify_one();
+
+    if (renderThread.joinable())
+        renderThread.join();
+}
+
+void Window::renderLoop(GLsync sharedReady)
 {
     glfwMakeContextCurrent(window);
-    glViewport(0, 0, width, height);
+    glfwSwapInterval(swapInterval);
+
+    if (sharedReady)
+        glWaitSync(sharedReady, 0, GL_TIMEOUT_IGNORED);
+
+    std::unique_lock<std::mutex> lock(stateMutex);
+    FramePacer pacer(targetFps);
+    pacer.setVsync(swapInterval > 0);
+    double pacedFps = targetFps;
+
+    while (running)
+    {
+        if (pacedFps != targetFps)
+        {
+            pacedFps = targetFps;
+            pacer.setTargetFps(pacedFps);
+        }
+
+        if (continuous)
+        {
+            double wait = pacer.secondsUntilNextFrame();
+            if (wait > 0.0)
+                wake.wait_for(lock, std::chrono::duration<double>(wait), [this]()
+                              { return !running; });
+        }
+        else
+        {
+            wake.wait(lock, [this]()
+                      { return !running || continuous || needsRedraw(); });
+        }
+
+        if (!running)
+            break;
+
+        lock.unlock();
+        pacer.beginFrame();
+        renderOnce();
+        pacer.endFrame();
+        lock.lock();
+    }
+    lock.unlock();
+
+    if (frameFence)
+    {
+        glDeleteSync(frameFence);
+        frameFence = nullptr;
+    }
+    glfwMakeContextCurrent(nullptr);
+}
+
+void Window::renderOnce()
+{
+    // cleared first so a request arriving mid-frame is not lost
+    dirty.store(false, std::memory_order_release);
+
+    if (glfwGetCurrentContext() != window)
+        glfwMakeContextCurrent(window);
+
+    // wait for the previous frame before reusing its buffers, keeps one frame in flight
+    if (frameFence)
+    {
+        glClientWaitSync(frameFence, GL_SYNC_FLUSH_COMMANDS_BIT, FRAME_FENCE_TIMEOUT_NS);
+        glDeleteSync(frameFence);
+        frameFence = nullptr;
+    }
+
+    glViewport(0, 0, fbWidth, fbHeight);
 
     glClearColor(r, g, b, a);
     glClear(GL_COLOR_BUFFER_BIT);
@@ -57,5 +201,9 @@ void Window::renderOnce()
     if (renderCallback)
         renderCallback(userData);
 
+    frameFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
     glfwSwapBuffers(window);
-}
\ No newline at end of file
+
+    if (swapCallback)
+        swapCallback(userData);
+}
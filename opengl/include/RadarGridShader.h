@@ -0,0 +1,99 @@
+#ifndef RadarGridShader_H
+#define RadarGridShader_H
+
+#include "RadarGeometry.h"
+#include "RadarTypes.h"
+
+// Grid without geometry: one triangle covers the viewport and the fragment
+// shader finds the distance to the nearest ring (from length(p)) and radial
+// (from atan(p)), converted to pixels with screen-space derivatives for the
+// anti-aliased edge. Ring and radial counts are uniforms, so changing them
+// costs nothing. Matches RadarGeometry::generateRings/generateRadials,
+// including the sector: only its bounding box is drawn and fragments outside
+// the arc are discarded.
+class RadarGridShader
+{
+public:
+    RadarGridShader();
+    ~RadarGridShader();
+
+    // sector of the geometry, full circle until set
+    void setSector(const RadarGeometry &geo);
+    // lineWidth in pixels
+    void render(int rings, int radials, float ringSpacing, const Vec4 &color, float lineWidth);
+
+private:
+    // quad over the sector's bounding box (lo.xy, hi.xy in NDC), as a 4 vertex strip
+    static constexpr const char *vertexShaderSrc = R"(#version 330 core
+uniform vec4 uBounds;
+out vec2 vPos;
+void main() {
+    vec2 t = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+    vPos = mix(uBounds.xy, uBounds.zw, t);
+    gl_Position = vec4(vPos, 0.0, 1.0);
+}
+)";
+
+    static constexpr const char *fragmentShaderSrc = R"(#version 330 core
+in vec2 vPos;
+uniform int uRings;
+uniform int uRadials;
+uniform float uRingSpacing;
+uniform float uHalfWidth;
+uniform vec4 uColor;
+uniform vec2 uSector; // start and width in radians, width 2 pi for the full circle
+out vec4 FragColor;
+
+const float TWO_PI = 6.28318530718;
+
+// distance in pixels to the zero line of f, given the derivatives of a
+// continuous version of f (the nearest ring/radial jumps between cells)
+float pixelDistance(float f, vec2 grad) {
+    return abs(f) / max(length(grad), 1e-6);
+}
+
+// coverage of the ray from the centre along angle th
+float rayCoverage(float th) {
+    // signed perpendicular distance to the ray's line, linear in p
+    vec2 u = vec2(cos(th), sin(th));
+    vec2 px = dFdx(vPos);
+    vec2 py = dFdy(vPos);
+    float f = u.x * vPos.y - u.y * vPos.x;
+    float d = pixelDistance(f, vec2(u.x * px.y - u.y * px.x, u.x * py.y - u.y * py.x));
+    return dot(u, vPos) >= 0.0 ? clamp(uHalfWidth + 0.5 - d, 0.0, 1.0) : 0.0;
+}
+
+void main() {
+    float r = length(vPos);
+    float a = atan(vPos.y, vPos.x);
+    bool inside = mod(a - uSector.x, TWO_PI) <= uSector.y;
+    float coverage = 0.0;
+
+    if (uRings > 0 && inside) {
+        float k = clamp(floor(r / uRingSpacing + 0.5), 1.0, float(uRings));
+        float d = pixelDistance(r - k * uRingSpacing, vec2(dFdx(r), dFdy(r)));
+        coverage = max(coverage, clamp(uHalfWidth + 0.5 - d, 0.0, 1.0));
+    }
+
+    if (uRadials > 0 && r <= 1.0 && inside) {
+        float sector = TWO_PI / float(uRadials);
+        coverage = max(coverage, rayCoverage(floor(a / sector + 0.5) * sector));
+    }
+
+    // sector edges
+    if (uSector.y < TWO_PI && r <= 1.0)
+        coverage = max(coverage, max(rayCoverage(uSector.x), rayCoverage(uSector.x + uSector.y)));
+
+    if (coverage <= 0.0)
+        discard;
+    FragColor = vec4(uColor.rgb, uColor.a * coverage);
+}
+)";
+
+    unsigned int VAO, shaderProgram;
+    int ringsLocation, radialsLocation, spacingLocation, halfWidthLocation, colorLocation, sectorLocation, boundsLocation;
+    float sector[2];
+    float bounds[4];
+};
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef RadarLayerCache_H
+#define RadarLayerCache_H
+
+// Offscreen color target for layers that rarely change (grid),
+// drawn once and blitted into the host framebuffer every frame.
+class RadarLayerCache
+{
+public:
+    RadarLayerCache();
+    ~RadarLayerCache();
+
+    bool isValid(int width, int height) const { return valid && width == this->width && height == this->height; }
+    void invalidate() { valid = false; }
+
+    // bind the cache as draw target (resizing if needed) and clear it
+    void begin(int width, int height);
+    // bind a valid cache as draw target and clear only a pixel rectangle of
+    // it, drawing is scissored to the rectangle until end()
+    void beginRegion(int x, int y, int width, int height);
+    // restore the previous draw target and mark the cache valid
+    void end();
+    // copy the cached layer into a region of the currently bound draw framebuffer
+    void blit(int x, int y, int width, int height);
+    // color texture, for layers composited with a shader instead of a blit
+    unsigned int getTexture() const { return texture; }
+
+private:
+    unsigned int FBO, texture;
+    int width, height;
+    int prevDrawFBO;
+    int prevScissor[4];
+    bool prevScissorTest;
+    bool region;
+    bool valid;
+
+    void resize(int width, int height);
+    void cleanup();
+};
+
+#endif
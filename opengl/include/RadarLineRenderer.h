@@ -0,0 +1,75 @@
+#ifndef RadarLineRenderer_H
+#define RadarLineRenderer_H
+
+#include <vector>
+#include "RadarTypes.h"
+
+// Anti-aliased lines of any pixel width without GL_LINE_SMOOTH or wide
+// lines. Each segment of a GL_LINES vertex list is drawn as one instance
+// of a 4-vertex strip, expanded to a screen-space quad in the vertex shader;
+// the fragment shader fades the outer pixel from the distance to the centre
+// line, so edges are smooth with or without multisampling.
+class RadarLineRenderer
+{
+public:
+    RadarLineRenderer();
+    ~RadarLineRenderer();
+
+    // vertex pairs, same layout as for GL_LINES
+    void upload(const std::vector<RadarVertex> &vertices);
+    // width in pixels; the viewport size converts clip space to pixels
+    void render(float width, int viewportWidth, int viewportHeight);
+
+    int getSegmentCount() const { return segmentCount; }
+
+private:
+    static constexpr const char *vertexShaderSrc = R"(#version 330 core
+layout(location = 0) in vec2 aFrom;
+layout(location = 1) in vec4 aColor;
+layout(location = 2) in vec2 aTo;
+uniform vec2 uViewport;
+uniform float uHalfWidth;
+out vec4 vColor;
+out float vDistance;
+void main() {
+    // corner 0..3 of the strip: along the segment, then across it
+    float along = float(gl_VertexID >> 1);
+    float side = float(gl_VertexID & 1) * 2.0 - 1.0;
+
+    vec2 a = aFrom * 0.5 * uViewport;
+    vec2 b = aTo * 0.5 * uViewport;
+    vec2 dir = b - a;
+    float len = length(dir);
+    dir = len > 0.0 ? dir / len : vec2(1.0, 0.0);
+    vec2 normal = vec2(-dir.y, dir.x);
+
+    // one extra pixel across holds the anti-aliased edge, half a pixel
+    // along closes the joints between segments of a ring
+    float extent = uHalfWidth + 1.0;
+    vec2 p = mix(a - dir * 0.5, b + dir * 0.5, along) + normal * side * extent;
+
+    vDistance = side * extent;
+    vColor = aColor;
+    gl_Position = vec4(p / (0.5 * uViewport), 0.0, 1.0);
+}
+)";
+
+    static constexpr const char *fragmentShaderSrc = R"(#version 330 core
+in vec4 vColor;
+in float vDistance;
+uniform float uHalfWidth;
+out vec4 FragColor;
+void main() {
+    float coverage = clamp(uHalfWidth + 0.5 - abs(vDistance), 0.0, 1.0);
+    if (coverage <= 0.0)
+        discard;
+    FragColor = vec4(vColor.rgb, vColor.a * coverage);
+}
+)";
+
+    unsigned int VAO, VBO, shaderProgram;
+    int viewportLocation, halfWidthLocation;
+    int segmentCount;
+};
+
+#endif
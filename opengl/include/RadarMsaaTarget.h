@@ -0,0 +1,29 @@
+#ifndef RadarMsaaTarget_H
+#define RadarMsaaTarget_H
+
+// Multisampled offscreen target: a scope is drawn into it and resolved
+// into the host framebuffer once per frame.
+class RadarMsaaTarget
+{
+public:
+    RadarMsaaTarget();
+    ~RadarMsaaTarget();
+
+    // bind as draw target (reallocating on size or sample change) and clear
+    void begin(int width, int height, int samples);
+    // restore the previous draw target and resolve into its (x, y) region
+    void resolve(int x, int y);
+
+    int getSamples() const { return samples; }
+
+private:
+    unsigned int FBO, colorBuffer;
+    int width, height, samples;
+    int requested;
+    int prevDrawFBO;
+
+    void resize(int width, int height, int samples);
+    void cleanup();
+};
+
+#endif
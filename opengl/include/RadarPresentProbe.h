@@ -0,0 +1,43 @@
+#ifndef RadarPresentProbe_H
+#define RadarPresentProbe_H
+
+#include <cstddef>
+#include <deque>
+#include <vector>
+#include "RadarLatencyTracker.h"
+
+// Closes the latency loop on the GPU side: after a swap, a timestamp query
+// records when the GPU has executed the frame, including the swap. The
+// query is read back on a later frame without stalling, and the GPU time is
+// mapped to the wall clock with the GPU and CPU times taken at submission.
+// Render thread only, with the window's context current.
+class RadarPresentProbe
+{
+public:
+    explicit RadarPresentProbe(RadarLatencyTracker &tracker = RadarLatencyTracker::shared());
+    ~RadarPresentProbe();
+
+    // right after SwapBuffers, for the spokes uploaded in that frame;
+    // frames without spokes are skipped
+    void submit(RadarLatencyTracker::Frame &&frame);
+    // records frames whose query result is available, never waits
+    void poll();
+
+private:
+    struct Pending
+    {
+        unsigned int query;
+        int64_t cpuAtSubmit;
+        int64_t gpuAtSubmit;
+        RadarLatencyTracker::Frame frame;
+    };
+
+    // frames in flight before new ones are dropped instead of queried
+    static const size_t MAX_PENDING = 8;
+
+    RadarLatencyTracker &tracker;
+    std::deque<Pending> pending;
+    std::vector<unsigned int> freeQueries;
+};
+
+#endif
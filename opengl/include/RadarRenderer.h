@@ -7,15 +7,29 @@ class RadarRenderer
 {
 public:
     RadarRenderer();
+    // use a program created once for the whole share group, it is not deleted by this renderer
+    explicit RadarRenderer(unsigned int sharedProgram);
+    // no GL calls until create(), for renderers embedded in objects built without a context
+    struct Deferred
+    {
+    };
+    explicit RadarRenderer(Deferred);
     ~RadarRenderer();
 
+    // create the GL objects of a Deferred renderer; 0 compiles its own program
+    void create(unsigned int sharedProgram = 0);
+    bool isCreated() const { return VAO != 0; }
+
+    // compile the vertex-color program, for sharing between contexts
+    static unsigned int createProgram();
+
     void upload(const std::vector<RadarVertex> &vertices);
     void render(unsigned int drawMode);
 
     int getVertexCount() { return vertexCount; }
 
 private:
-    const char *vertexShaderSrc = R"(#version 330 core
+    static constexpr const char *vertexShaderSrc = R"(#version 330 core
 layout(location = 0) in vec2 aPos;
 layout(location = 1) in vec4 aColor;
 out vec4 vColor;
@@ -25,7 +39,7 @@ void main() {
 }
 )";
 
-    const char *fragmentShaderSrc = R"(#version 330 core
+    static constexpr const char *fragmentShaderSrc = R"(#version 330 core
 in vec4 vColor;
 out vec4 FragColor;
 void main() {
@@ -35,11 +49,11 @@ void main() {
 
     unsigned int VAO, VBO, vertexCount;
     unsigned int shaderProgram;
+    bool ownsProgram;
 
+    void init();
     void cleanup();
     void CreateShaderProgram();
-    unsigned int compileShader(unsigned int type, const char *src);
-    void checkShaderProgramErrors(unsigned int shaderProgram);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,9 @@
+#ifndef RadarShaderProgram_H
+#define RadarShaderProgram_H
+
+// Compile a vertex and a fragment shader and link them into a program.
+// Throws std::runtime_error with the driver's log on a compile or link
+// error; nothing is left allocated in that case.
+unsigned int radarLinkProgram(const char *vertexSrc, const char *fragmentSrc);
+
+#endif
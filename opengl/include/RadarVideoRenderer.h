@@ -0,0 +1,125 @@
+#ifndef RadarVideoRenderer_H
+#define RadarVideoRenderer_H
+
+#include "RadarGeometry.h"
+#include "RadarLayerCache.h"
+#include "RadarPolarImage.h"
+#include "RadarPolarPyramid.h"
+#include "RadarTypes.h"
+#include <vector>
+
+// Draws polar radar video. The image is kept as a single-channel texture
+// (range bins across, azimuths down) and scan converted per pixel in the
+// fragment shader, so there is no Cartesian resampling on the CPU.
+// With live video only the rows the sweep crossed since the last frame
+// change: uploadSwept sends just those rows, and the optional Cartesian
+// cache converts only their wedge again, so the per-frame cost follows
+// the sweep rate instead of the image size. Given a pyramid, its levels are
+// kept as textures too and a zoomed-out scope samples the level matching
+// its pixels per range bin, so small targets survive without aliasing.
+class RadarVideoRenderer
+{
+public:
+    RadarVideoRenderer();
+    ~RadarVideoRenderer();
+
+    void setColor(const Vec4 &color);
+    // draw only the geometry's sector: a quad over its bounding box, with
+    // fragments outside the arc discarded before the texture fetch
+    void setSector(const RadarGeometry &geo);
+
+    // upload the whole image and pyramid (optional, built from the image),
+    // textures are reallocated when their size changes
+    void upload(const RadarPolarImage &image, const RadarPolarPyramid *pyramid = nullptr);
+    // upload count rows from first, continuing at row 0 past the last row,
+    // and the pyramid rows holding them
+    void uploadRows(const RadarPolarImage &image, int first, int count, const RadarPolarPyramid *pyramid = nullptr);
+    // upload the rows crossed by the sweep between the previous and the
+    // current frame's angle (degrees, the shorter way round)
+    void uploadSwept(const RadarPolarImage &image, float fromDegrees, float toDegrees,
+                     const RadarPolarPyramid *pyramid = nullptr);
+
+    // keep the scan-converted video in an offscreen layer of the viewport's
+    // size; render() converts only the bounding box of the rows uploaded
+    // since the last frame again and composites the layer as one quad
+    void setCartesianCache(bool enabled);
+    void render();
+
+private:
+    // quad over the sector's bounding box (lo.xy, hi.xy in NDC, the whole
+    // viewport by default) as a 4 vertex strip, no vertex buffer needed
+    static constexpr const char *vertexShaderSrc = R"(#version 330 core
+uniform vec4 uBounds;
+out vec2 vPos;
+void main() {
+    vec2 t = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+    vPos = mix(uBounds.xy, uBounds.zw, t);
+    gl_Position = vec4(vPos, 0.0, 1.0);
+}
+)";
+
+    // same polar convention as RadarGeometry: angle from +x towards +y, radius 1 at the edge
+    static constexpr const char *fragmentShaderSrc = R"(#version 330 core
+in vec2 vPos;
+uniform sampler2D uVideo;
+uniform vec4 uColor;
+uniform vec2 uSector; // start and width in turns, width 1 for the full circle
+out vec4 FragColor;
+void main() {
+    float r = length(vPos);
+    if (r > 1.0)
+        discard;
+    float turn = fract(atan(vPos.y, vPos.x) / 6.28318530718);
+    if (fract(turn - uSector.x) > uSector.y)
+        discard;
+    float amplitude = texture(uVideo, vec2(r, turn)).r;
+    if (amplitude <= 0.0)
+        discard;
+    FragColor = vec4(uColor.rgb, uColor.a * amplitude);
+}
+)";
+
+    // cached layer holds premultiplied color, drawn over the sector's box
+    static constexpr const char *compositeShaderSrc = R"(#version 330 core
+in vec2 vPos;
+uniform sampler2D uLayer;
+out vec4 FragColor;
+void main() {
+    FragColor = texture(uLayer, vPos * 0.5 + 0.5);
+}
+)";
+
+    struct RowSpan
+    {
+        int first, count;
+    };
+
+    struct LevelTexture
+    {
+        unsigned int texture;
+        int width, height;
+    };
+
+    unsigned int VAO, texture, shaderProgram, compositeProgram;
+    int colorLocation, sectorLocation, boundsLocation, compositeBoundsLocation;
+    float sector[2];
+    float bounds[4];
+    int width, height;
+    Vec4 color;
+    // pyramid levels 1..n and the one sampled by the last render (0 for the image)
+    std::vector<LevelTexture> levels;
+    int drawLevel;
+
+    RadarLayerCache *cache;
+    // rows uploaded since the cache was last converted, all of them when set
+    std::vector<RowSpan> dirtyRows;
+    bool dirtyAll;
+
+    bool levelsMatch(const RadarPolarPyramid *pyramid) const;
+    void markDirty(int first, int count);
+    void drawVideo();
+    // pixel rectangle of the dirty rows' wedges in a viewport of w x h
+    void dirtyRect(int w, int h, int rect[4]) const;
+};
+
+#endif
@@ -1,7 +1,8 @@
 #ifndef RADAR_GL_API_H
 #define RADAR_GL_API_H
 
-#include "RadarContext.h"
+#include <cstdint>
+#include "RadarFrameExport.h"
 
 #ifdef _WIN32
 #ifdef RADAR_BUILD_DLL
@@ -15,12 +16,110 @@
 #define RADAR_CALL
 #endif
 
+// Scopes are referred to by handle: slot index and generation packed in 32
+// bits, 0 is never valid. A destroyed scope's handle is rejected by every
+// call instead of touching freed memory.
+typedef uint32_t RadarHandle;
+
+// Summary of one latency stage (RadarLatencyStage), milliseconds; blittable
+struct RadarLatencyStats
+{
+    uint64_t count;
+    double meanMs;
+    double p50Ms;
+    double p95Ms;
+    double p99Ms;
+    double maxMs;
+};
+
+// Batch descriptors, one per scope. Plain sequential layout of blittable
+// fields so a C# host can pass a pinned struct array in a single call.
+struct RadarRenderDesc
+{
+    RadarHandle handle; // 0 or stale entries are skipped
+    int x, y;          // region of the bound framebuffer to draw into
+    int width, height;
+    double deltaTime;
+};
+
+enum RadarUpdateFlags
+{
+    RADAR_UPDATE_PARAMETER = 1,
+    RADAR_UPDATE_GEO = 2,
+    RADAR_UPDATE_COLOR = 4,
+    RADAR_UPDATE_STATIC_CACHE = 8
+};
+
+struct RadarUpdateDesc
+{
+    RadarHandle handle;
+    int flags; // RadarUpdateFlags, selects which groups below are applied
+    float sweepSpeed, tolerance;
+    int rings, radials, segment;
+    float gridColor[4];
+    float sweepColor[4];
+    int staticCache;
+};
+
 RADAR_API int radar_gl_init();
-RADAR_API RadarContext *radar_create(int rings, int radials, int segment, float sweepSpeed, float tolerance);
-RADAR_API void radar_update_parameter(RadarContext *ctx, float sweepSpeed, float tolerance);
-RADAR_API void radar_update_geo(RadarContext *ctx, int rings, int radials, int segment);
-RADAR_API float radar_render(RadarContext *ctx, int width, int height, double deltaTime);
-RADAR_API void radar_destroy(RadarContext *ctx);
+// returns 0 when no more scopes can be created
+RADAR_API RadarHandle radar_create(int rings, int radials, int segment, float sweepSpeed, float tolerance);
+RADAR_API void radar_update_parameter(RadarHandle handle, float sweepSpeed, float tolerance);
+RADAR_API void radar_update_geo(RadarHandle handle, int rings, int radials, int segment);
+RADAR_API void radar_update_color(RadarHandle handle, float gridR, float gridG, float gridB, float gridA,
+                                  float sweepR, float sweepG, float sweepB, float sweepA);
+RADAR_API void radar_set_static_cache(RadarHandle handle, int enabled);
+// width > 0 draws the grid as anti-aliased quads of that many pixels instead of
+// GL_LINES; msaaSamples > 1 renders through a multisampled target resolved once per frame
+RADAR_API void radar_set_line_style(RadarHandle handle, float width, int msaaSamples);
+// draw rings and radials per pixel in a fragment shader instead of from vertices;
+// grid changes then cost nothing. Uses the radar_set_line_style width.
+RADAR_API void radar_set_analytic_grid(RadarHandle handle, int enabled);
+// range-ring and bearing labels in the grid layer; range is the value shown at
+// the outer edge. Laid out once per grid and zoom bucket, drawn with the grid.
+RADAR_API void radar_set_grid_labels(RadarHandle handle, int enabled, float range);
+// restrict grid, sweep and analytic layers to the arc from start counter-clockwise
+// to end (degrees); start == end restores the full circle. scan != 0 moves the
+// sweep back and forth across the arc instead of rotating.
+RADAR_API void radar_set_sector(RadarHandle handle, float start, float end, int scan);
+// polar video (azimuth rows of range-bin amplitudes, row 0 at the sweep's 0
+// degrees) drawn under the sweep and clipped to the sector. rows holds rowCount
+// rows of bins bytes for the rows from firstRow on, continuing at row 0 past
+// the last; a new azimuths x bins size starts a blank image. GL thread.
+RADAR_API void radar_upload_video(RadarHandle handle, const unsigned char *rows, int azimuths, int bins,
+                                  int firstRow, int rowCount);
+// same, with each row's receive and decode time (wall clock ns since the Unix
+// epoch, 0 or a null array when unknown) for the latency stages; the rows are
+// traced until the radar_present after the frame that shows them
+RADAR_API void radar_upload_video_traced(RadarHandle handle, const unsigned char *rows, int azimuths, int bins,
+                                         int firstRow, int rowCount, const int64_t *receiveTimes,
+                                         const int64_t *decodeTimes);
+// video color at full amplitude, any thread
+RADAR_API void radar_set_video_color(RadarHandle handle, float r, float g, float b, float a);
+RADAR_API void radar_report_azimuth(RadarHandle handle, float azimuth);
+RADAR_API void radar_set_phase_lock(RadarHandle handle, int enabled);
+RADAR_API float radar_render(RadarHandle handle, int width, int height, double deltaTime);
+// render every scope in order, writing each sweep angle to outAngles[i];
+// returns the number of scopes drawn
+RADAR_API int radar_render_many(const RadarRenderDesc *descs, int count, float *outAngles);
+// same rules as the single setters, any thread
+RADAR_API void radar_update_many(const RadarUpdateDesc *descs, int count);
+// read back the bound framebuffer into the next slot of a frame ring created
+// with radar_export_create (radar_c_api), GL thread only; returns 1 on success
+RADAR_API int radar_export_frame(RadarHandle handle, RadarFrameExport *exporter, int width, int height);
+// right after the host swaps the frame radar_render drew, GL thread; its traced
+// rows are recorded as presented once the GPU has finished it, without waiting
+RADAR_API void radar_present(RadarHandle handle);
+RADAR_API void radar_destroy(RadarHandle handle);
+
+// --- Video latency per RadarLatencyStage, recorded by the traced uploads and
+// radar_present of every scope in this library; any thread
+RADAR_API int radar_latency_stats(int stage, RadarLatencyStats *out);
+// bucket counts and upper edges (ms), either array may be null; returns buckets written
+RADAR_API int radar_latency_histogram(int stage, uint64_t *counts, double *upperMs, int maxBuckets);
+// a sample measured by the host, e.g. its own decode stage
+RADAR_API void radar_latency_record(int stage, int64_t nanos);
+RADAR_API void radar_latency_reset();
 RADAR_API void radar_gl_deinit();
 
 #endif
@@ -0,0 +1,70 @@
+#include "RadarGridShader.h"
+#include "RadarShaderProgram.h"
+#include <GL/glew.h>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+RadarGridShader::RadarGridShader()
+    : VAO(0), shaderProgram(0), ringsLocation(-1), radialsLocation(-1), spacingLocation(-1), halfWidthLocation(-1),
+      colorLocation(-1), sectorLocation(-1), boundsLocation(-1), sector{0.0f, 6.28318530718f}, bounds{-1.0f, -1.0f, 1.0f, 1.0f}
+{
+    try
+    {
+        shaderProgram = radarLinkProgram(vertexShaderSrc, fragmentShaderSrc);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << '\n';
+    }
+
+    ringsLocation = glGetUniformLocation(shaderProgram, "uRings");
+    radialsLocation = glGetUniformLocation(shaderProgram, "uRadials");
+    spacingLocation = glGetUniformLocation(shaderProgram, "uRingSpacing");
+    halfWidthLocation = glGetUniformLocation(shaderProgram, "uHalfWidth");
+    colorLocation = glGetUniformLocation(shaderProgram, "uColor");
+    sectorLocation = glGetUniformLocation(shaderProgram, "uSector");
+    boundsLocation = glGetUniformLocation(shaderProgram, "uBounds");
+
+    // core profile needs a bound VAO even without attributes
+    glGenVertexArrays(1, &VAO);
+}
+
+RadarGridShader::~RadarGridShader()
+{
+    if (VAO)
+        glDeleteVertexArrays(1, &VAO);
+    if (shaderProgram)
+        glDeleteProgram(shaderProgram);
+}
+
+void RadarGridShader::setSector(const RadarGeometry &geo)
+{
+    const float DEG_TO_RAD = 3.14159265358979323846f / 180.0f;
+    Vec2 lo, hi;
+    geo.getSectorBounds(lo, hi);
+
+    sector[0] = geo.getSectorStart() * DEG_TO_RAD;
+    sector[1] = geo.hasSector() ? geo.getSectorWidth() * DEG_TO_RAD : 6.28318530718f;
+    bounds[0] = lo.x;
+    bounds[1] = lo.y;
+    bounds[2] = hi.x;
+    bounds[3] = hi.y;
+}
+
+void RadarGridShader::render(int rings, int radials, float ringSpacing, const Vec4 &color, float lineWidth)
+{
+    glUseProgram(shaderProgram);
+    glUniform1i(ringsLocation, rings);
+    glUniform1i(radialsLocation, radials);
+    glUniform1f(spacingLocation, ringSpacing);
+    glUniform1f(halfWidthLocation, lineWidth * 0.5f);
+    glUniform4f(colorLocation, color.r, color.g, color.b, color.a);
+    glUniform2fv(sectorLocation, 1, sector);
+    glUniform4fv(boundsLocation, 1, bounds);
+
+    glBindVertexArray(VAO);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glBindVertexArray(0);
+    glUseProgram(0);
+}
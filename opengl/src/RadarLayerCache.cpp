@@ -0,0 +1,104 @@
+#include "RadarLayerCache.h"
+#include <GL/glew.h>
+#include <iostream>
+
+RadarLayerCache::RadarLayerCache()
+    : FBO(0), texture(0), width(0), height(0), prevDrawFBO(0), prevScissor{0, 0, 0, 0}, prevScissorTest(false),
+      region(false), valid(false)
+{
+}
+
+RadarLayerCache::~RadarLayerCache()
+{
+    cleanup();
+}
+
+void RadarLayerCache::resize(int width, int height)
+{
+    cleanup();
+
+    this->width = width;
+    this->height = height;
+
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenFramebuffers(1, &FBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cerr << "RadarLayerCache: framebuffer incomplete (" << width << "x" << height << ")\n";
+
+    glBindFramebuffer(GL_FRAMEBUFFER, prevDrawFBO);
+}
+
+void RadarLayerCache::begin(int width, int height)
+{
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &prevDrawFBO);
+
+    if (width != this->width || height != this->height || !FBO)
+        resize(width, height);
+
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, FBO);
+    glViewport(0, 0, width, height);
+    glClear(GL_COLOR_BUFFER_BIT);
+}
+
+void RadarLayerCache::beginRegion(int x, int y, int width, int height)
+{
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &prevDrawFBO);
+    glGetIntegerv(GL_SCISSOR_BOX, prevScissor);
+    prevScissorTest = glIsEnabled(GL_SCISSOR_TEST);
+    region = true;
+
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, FBO);
+    glViewport(0, 0, this->width, this->height);
+    glScissor(x, y, width, height);
+    glEnable(GL_SCISSOR_TEST);
+    glClear(GL_COLOR_BUFFER_BIT);
+}
+
+void RadarLayerCache::end()
+{
+    if (region)
+    {
+        glScissor(prevScissor[0], prevScissor[1], prevScissor[2], prevScissor[3]);
+        if (!prevScissorTest)
+            glDisable(GL_SCISSOR_TEST);
+        region = false;
+    }
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, prevDrawFBO);
+    valid = true;
+}
+
+void RadarLayerCache::blit(int x, int y, int width, int height)
+{
+    GLint prevReadFBO = 0;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &prevReadFBO);
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, FBO);
+    glBlitFramebuffer(0, 0, this->width, this->height, x, y, x + width, y + height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, prevReadFBO);
+}
+
+void RadarLayerCache::cleanup()
+{
+    if (FBO)
+    {
+        glDeleteFramebuffers(1, &FBO);
+        FBO = 0;
+    }
+
+    if (texture)
+    {
+        glDeleteTextures(1, &texture);
+        texture = 0;
+    }
+
+    valid = false;
+}
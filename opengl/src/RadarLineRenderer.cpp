@@ -0,0 +1,78 @@
+#include "RadarLineRenderer.h"
+#include "RadarShaderProgram.h"
+#include <GL/glew.h>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+RadarLineRenderer::RadarLineRenderer()
+    : VAO(0), VBO(0), shaderProgram(0), viewportLocation(-1), halfWidthLocation(-1), segmentCount(0)
+{
+    try
+    {
+        shaderProgram = radarLinkProgram(vertexShaderSrc, fragmentShaderSrc);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << '\n';
+    }
+
+    viewportLocation = glGetUniformLocation(shaderProgram, "uViewport");
+    halfWidthLocation = glGetUniformLocation(shaderProgram, "uHalfWidth");
+
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+
+    // the GL_LINES buffer is read two vertices per instance: start position
+    // and color from the first, end position from the second
+    const GLsizei stride = 2 * sizeof(RadarVertex);
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (void *)0);
+    glVertexAttribDivisor(0, 1);
+
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, stride, (void *)(sizeof(Vec2)));
+    glVertexAttribDivisor(1, 1);
+
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void *)(sizeof(RadarVertex)));
+    glVertexAttribDivisor(2, 1);
+
+    glBindVertexArray(0);
+}
+
+RadarLineRenderer::~RadarLineRenderer()
+{
+    if (VBO)
+        glDeleteBuffers(1, &VBO);
+    if (VAO)
+        glDeleteVertexArrays(1, &VAO);
+    if (shaderProgram)
+        glDeleteProgram(shaderProgram);
+}
+
+void RadarLineRenderer::upload(const std::vector<RadarVertex> &vertices)
+{
+    segmentCount = (int)(vertices.size() / 2);
+
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, segmentCount * 2 * sizeof(RadarVertex), vertices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void RadarLineRenderer::render(float width, int viewportWidth, int viewportHeight)
+{
+    if (segmentCount == 0)
+        return;
+
+    glUseProgram(shaderProgram);
+    glUniform2f(viewportLocation, (float)viewportWidth, (float)viewportHeight);
+    glUniform1f(halfWidthLocation, width * 0.5f);
+    glBindVertexArray(VAO);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, segmentCount);
+    glBindVertexArray(0);
+    glUseProgram(0);
+}
@@ -0,0 +1,82 @@
+#include "RadarMsaaTarget.h"
+#include <GL/glew.h>
+#include <iostream>
+
+RadarMsaaTarget::RadarMsaaTarget() : FBO(0), colorBuffer(0), width(0), height(0), samples(0), requested(0), prevDrawFBO(0)
+{
+}
+
+RadarMsaaTarget::~RadarMsaaTarget()
+{
+    cleanup();
+}
+
+void RadarMsaaTarget::resize(int width, int height, int samples)
+{
+    cleanup();
+
+    GLint maxSamples = 0;
+    glGetIntegerv(GL_MAX_SAMPLES, &maxSamples);
+    if (samples > maxSamples)
+        samples = maxSamples;
+
+    this->width = width;
+    this->height = height;
+    this->samples = samples;
+
+    glGenRenderbuffers(1, &colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, GL_RGBA8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &FBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cerr << "RadarMsaaTarget: framebuffer incomplete (" << width << "x" << height << ", " << samples << " samples)\n";
+
+    glBindFramebuffer(GL_FRAMEBUFFER, prevDrawFBO);
+}
+
+void RadarMsaaTarget::begin(int width, int height, int samples)
+{
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &prevDrawFBO);
+
+    // requested count may have been clamped to the driver limit, compare with what was asked
+    if (width != this->width || height != this->height || !FBO || samples != requested)
+    {
+        requested = samples;
+        resize(width, height, samples);
+    }
+
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, FBO);
+    glViewport(0, 0, width, height);
+    glClear(GL_COLOR_BUFFER_BIT);
+}
+
+void RadarMsaaTarget::resolve(int x, int y)
+{
+    GLint prevReadFBO = 0;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &prevReadFBO);
+
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, prevDrawFBO);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, FBO);
+    glBlitFramebuffer(0, 0, width, height, x, y, x + width, y + height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, prevReadFBO);
+}
+
+void RadarMsaaTarget::cleanup()
+{
+    if (FBO)
+    {
+        glDeleteFramebuffers(1, &FBO);
+        FBO = 0;
+    }
+
+    if (colorBuffer)
+    {
+        glDeleteRenderbuffers(1, &colorBuffer);
+        colorBuffer = 0;
+    }
+}
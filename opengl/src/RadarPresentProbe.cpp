@@ -0,0 +1,68 @@
+#include "RadarPresentProbe.h"
+#include <GL/glew.h>
+
+RadarPresentProbe::RadarPresentProbe(RadarLatencyTracker &tracker) : tracker(tracker)
+{
+}
+
+RadarPresentProbe::~RadarPresentProbe()
+{
+    for (const Pending &p : pending)
+        freeQueries.push_back(p.query);
+    if (!freeQueries.empty())
+        glDeleteQueries((GLsizei)freeQueries.size(), freeQueries.data());
+}
+
+void RadarPresentProbe::submit(RadarLatencyTracker::Frame &&frame)
+{
+    poll();
+    if (frame.receiveTimes.empty() || pending.size() >= MAX_PENDING)
+        return;
+
+    Pending p;
+    if (freeQueries.empty())
+    {
+        glGenQueries(1, &p.query);
+    }
+    else
+    {
+        p.query = freeQueries.back();
+        freeQueries.pop_back();
+    }
+
+    // GL_TIMESTAMP read now is the GPU clock when the query is issued, the
+    // query result is the GPU clock once everything before it has executed
+    GLint64 gpuNow = 0;
+    glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+    p.cpuAtSubmit = RadarLatencyTracker::now();
+    p.gpuAtSubmit = gpuNow;
+    glQueryCounter(p.query, GL_TIMESTAMP);
+    // otherwise the query may sit in the command buffer until the next frame
+    glFlush();
+    p.frame = std::move(frame);
+    pending.push_back(std::move(p));
+}
+
+void RadarPresentProbe::poll()
+{
+    // queries complete in order
+    while (!pending.empty())
+    {
+        Pending &p = pending.front();
+        GLint available = 0;
+        glGetQueryObjectiv(p.query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+            break;
+
+        GLuint64 gpuDone = 0;
+        glGetQueryObjectui64v(p.query, GL_QUERY_RESULT, &gpuDone);
+        int64_t presented = p.cpuAtSubmit + ((int64_t)gpuDone - p.gpuAtSubmit);
+        // never before the submission, GPU and CPU clocks are only paired loosely
+        if (presented < p.cpuAtSubmit)
+            presented = p.cpuAtSubmit;
+        tracker.presented(p.frame, presented);
+
+        freeQueries.push_back(p.query);
+        pending.pop_front();
+    }
+}
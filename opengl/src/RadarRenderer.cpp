@@ -1,19 +1,48 @@
 #include "RadarRenderer.h"
+#include "RadarShaderProgram.h"
 #include <GL/glew.h>
 #include <iostream>
 
-RadarRenderer::RadarRenderer() : vertexCount(0)
+RadarRenderer::RadarRenderer() : vertexCount(0), shaderProgram(0), ownsProgram(true)
 {
     CreateShaderProgram();
-    glGenVertexArrays(1, &VAO);
-    glBindVertexArray(VAO);
-    glGenBuffers(1, &VBO);
+    init();
+}
+
+RadarRenderer::RadarRenderer(unsigned int sharedProgram) : vertexCount(0), shaderProgram(sharedProgram), ownsProgram(false)
+{
+    init();
+}
+
+RadarRenderer::RadarRenderer(Deferred) : VAO(0), VBO(0), vertexCount(0), shaderProgram(0), ownsProgram(false)
+{
 }
 
 RadarRenderer::~RadarRenderer()
 {
     cleanup();
-    glDeleteProgram(this->shaderProgram);
+    if (ownsProgram)
+        glDeleteProgram(this->shaderProgram);
+}
+
+void RadarRenderer::create(unsigned int sharedProgram)
+{
+    if (isCreated())
+        return;
+
+    shaderProgram = sharedProgram;
+    ownsProgram = sharedProgram == 0;
+    if (ownsProgram)
+        CreateShaderProgram();
+    init();
+}
+
+void RadarRenderer::init()
+{
+    // VAOs are never shared between contexts, so each renderer keeps its own
+    glGenVertexArrays(1, &VAO);
+    glBindVertexArray(VAO);
+    glGenBuffers(1, &VBO);
 }
 
 void RadarRenderer::upload(const std::vector<RadarVertex> &vertices)
@@ -68,55 +97,20 @@ void RadarRenderer::cleanup()
 }
 
 void RadarRenderer::CreateShaderProgram()
+{
+    // Store the program ID
+    this->shaderProgram = createProgram();
+}
+
+unsigned int RadarRenderer::createProgram()
 {
     try
     {
-        GLuint vs = compileShader(GL_VERTEX_SHADER, vertexShaderSrc);
-        GLuint fs = compileShader(GL_FRAGMENT_SHADER, fragmentShaderSrc);
-
-        GLuint prog = glCreateProgram();
-        glAttachShader(prog, vs);
-        glAttachShader(prog, fs);
-        glLinkProgram(prog);
-
-        checkShaderProgramErrors(prog);
-
-        glDeleteShader(vs);
-        glDeleteShader(fs);
-
-        // Store the program ID
-        this->shaderProgram = prog;
+        return radarLinkProgram(vertexShaderSrc, fragmentShaderSrc);
     }
     catch (const std::exception &e)
     {
         std::cerr << e.what() << '\n';
     }
+    return 0;
 }
-
-unsigned int RadarRenderer::compileShader(unsigned int type, const char *src)
-{
-    GLuint s = glCreateShader(type);
-    glShaderSource(s, 1, &src, nullptr);
-    glCompileShader(s);
-    GLint status;
-    glGetShaderiv(s, GL_COMPILE_STATUS, &status);
-    if (!status)
-    {
-        char log[512];
-        glGetShaderInfoLog(s, 512, nullptr, log);
-        throw std::runtime_error(std::string("Shader compile error: ") + log);
-    }
-    return s;
-}
-
-void RadarRenderer::checkShaderProgramErrors(unsigned int shaderProgram)
-{
-    int success;
-    char infoLog[512];
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-    if (!success)
-    {
-        glGetProgramInfoLog(shaderProgram, 512, nullptr, infoLog);
-        throw std::runtime_error("ERROR::SHADER::PROGRAM::LINKING_FAILED\n" + std::string(infoLog));
-    }
-}
\ No newline at end of file
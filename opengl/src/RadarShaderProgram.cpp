@@ -0,0 +1,54 @@
+#include "RadarShaderProgram.h"
+#include <GL/glew.h>
+#include <stdexcept>
+#include <string>
+
+static GLuint compileShader(GLenum type, const char *src)
+{
+    GLuint s = glCreateShader(type);
+    glShaderSource(s, 1, &src, nullptr);
+    glCompileShader(s);
+    GLint status;
+    glGetShaderiv(s, GL_COMPILE_STATUS, &status);
+    if (!status)
+    {
+        char log[512];
+        glGetShaderInfoLog(s, 512, nullptr, log);
+        glDeleteShader(s);
+        throw std::runtime_error(std::string("Shader compile error: ") + log);
+    }
+    return s;
+}
+
+unsigned int radarLinkProgram(const char *vertexSrc, const char *fragmentSrc)
+{
+    GLuint vs = compileShader(GL_VERTEX_SHADER, vertexSrc);
+    GLuint fs;
+    try
+    {
+        fs = compileShader(GL_FRAGMENT_SHADER, fragmentSrc);
+    }
+    catch (...)
+    {
+        glDeleteShader(vs);
+        throw;
+    }
+
+    GLuint program = glCreateProgram();
+    glAttachShader(program, vs);
+    glAttachShader(program, fs);
+    glLinkProgram(program);
+    glDeleteShader(vs);
+    glDeleteShader(fs);
+
+    GLint success;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success)
+    {
+        char infoLog[512];
+        glGetProgramInfoLog(program, 512, nullptr, infoLog);
+        glDeleteProgram(program);
+        throw std::runtime_error("ERROR::SHADER::PROGRAM::LINKING_FAILED\n" + std::string(infoLog));
+    }
+    return program;
+}
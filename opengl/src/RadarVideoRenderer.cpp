@@ -0,0 +1,343 @@
+#include "RadarVideoRenderer.h"
+#include "RadarShaderProgram.h"
+#include <GL/glew.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+// single channel video texture, linear in range and azimuth
+static GLuint createVideoTexture()
+{
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    // azimuth wraps around north
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return texture;
+}
+
+RadarVideoRenderer::RadarVideoRenderer()
+    : VAO(0), texture(0), shaderProgram(0), compositeProgram(0), colorLocation(-1), sectorLocation(-1),
+      boundsLocation(-1), compositeBoundsLocation(-1), sector{0.0f, 1.0f}, bounds{-1.0f, -1.0f, 1.0f, 1.0f},
+      width(0), height(0), color(1.0f, 1.0f, 0.0f, 1.0f), drawLevel(0), cache(nullptr), dirtyAll(true)
+{
+    try
+    {
+        shaderProgram = radarLinkProgram(vertexShaderSrc, fragmentShaderSrc);
+        compositeProgram = radarLinkProgram(vertexShaderSrc, compositeShaderSrc);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << '\n';
+    }
+
+    glUseProgram(shaderProgram);
+    glUniform1i(glGetUniformLocation(shaderProgram, "uVideo"), 0);
+    colorLocation = glGetUniformLocation(shaderProgram, "uColor");
+    sectorLocation = glGetUniformLocation(shaderProgram, "uSector");
+    boundsLocation = glGetUniformLocation(shaderProgram, "uBounds");
+    glUseProgram(compositeProgram);
+    glUniform1i(glGetUniformLocation(compositeProgram, "uLayer"), 0);
+    compositeBoundsLocation = glGetUniformLocation(compositeProgram, "uBounds");
+    glUseProgram(0);
+
+    // core profile needs a bound VAO even without attributes
+    glGenVertexArrays(1, &VAO);
+
+    texture = createVideoTexture();
+}
+
+RadarVideoRenderer::~RadarVideoRenderer()
+{
+    delete cache;
+    if (texture)
+        glDeleteTextures(1, &texture);
+    for (const LevelTexture &level : levels)
+        glDeleteTextures(1, &level.texture);
+    if (VAO)
+        glDeleteVertexArrays(1, &VAO);
+    if (shaderProgram)
+        glDeleteProgram(shaderProgram);
+    if (compositeProgram)
+        glDeleteProgram(compositeProgram);
+}
+
+void RadarVideoRenderer::setColor(const Vec4 &color)
+{
+    if (color.r != this->color.r || color.g != this->color.g || color.b != this->color.b || color.a != this->color.a)
+        dirtyAll = true;
+    this->color = color;
+}
+
+// rows first..first + count - 1 of an image into a texture of its size
+static void uploadVideoRows(GLuint texture, const RadarPolarImage &image, int first, int count)
+{
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, first, image.bins, count, GL_RED, GL_UNSIGNED_BYTE, image.row(first));
+}
+
+void RadarVideoRenderer::upload(const RadarPolarImage &image, const RadarPolarPyramid *pyramid)
+{
+    if (image.azimuths == 0 || image.bins == 0)
+        return;
+
+    GLint prevAlignment;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &prevAlignment);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glBindTexture(GL_TEXTURE_2D, texture);
+
+    if (image.bins != width || image.azimuths != height)
+    {
+        width = image.bins;
+        height = image.azimuths;
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, width, height, 0, GL_RED, GL_UNSIGNED_BYTE, image.data.data());
+    }
+    else
+    {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RED, GL_UNSIGNED_BYTE, image.data.data());
+    }
+
+    // one texture per pyramid level, reallocated when the levels change
+    int levelCount = pyramid ? pyramid->getLevelCount() : 0;
+    while ((int)levels.size() > levelCount)
+    {
+        glDeleteTextures(1, &levels.back().texture);
+        levels.pop_back();
+    }
+    while ((int)levels.size() < levelCount)
+        levels.push_back({createVideoTexture(), 0, 0});
+    for (int l = 1; l <= levelCount; l++)
+    {
+        const RadarPolarImage &src = pyramid->getLevel(l);
+        LevelTexture &level = levels[l - 1];
+        glBindTexture(GL_TEXTURE_2D, level.texture);
+        if (src.bins != level.width || src.azimuths != level.height)
+        {
+            level.width = src.bins;
+            level.height = src.azimuths;
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, level.width, level.height, 0, GL_RED, GL_UNSIGNED_BYTE, src.data.data());
+        }
+        else
+        {
+            uploadVideoRows(level.texture, src, 0, src.azimuths);
+        }
+    }
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, prevAlignment);
+    dirtyAll = true;
+}
+
+bool RadarVideoRenderer::levelsMatch(const RadarPolarPyramid *pyramid) const
+{
+    int levelCount = pyramid ? pyramid->getLevelCount() : 0;
+    if ((int)levels.size() != levelCount)
+        return false;
+    for (int l = 1; l <= levelCount; l++)
+    {
+        const RadarPolarImage &src = pyramid->getLevel(l);
+        if (src.bins != levels[l - 1].width || src.azimuths != levels[l - 1].height)
+            return false;
+    }
+    return true;
+}
+
+void RadarVideoRenderer::uploadRows(const RadarPolarImage &image, int first, int count, const RadarPolarPyramid *pyramid)
+{
+    if (image.azimuths == 0 || image.bins == 0)
+        return;
+
+    // a new size needs the whole texture
+    if (image.bins != width || image.azimuths != height || count >= height || !levelsMatch(pyramid))
+    {
+        upload(image, pyramid);
+        return;
+    }
+    if (count <= 0)
+        return;
+
+    first %= height;
+    if (first < 0)
+        first += height;
+
+    GLint prevAlignment;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &prevAlignment);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    // rows past the last one wrap to the start of the texture, each level
+    // takes the rows holding the uploaded image rows
+    auto uploadSpan = [&](int spanFirst, int spanCount)
+    {
+        uploadVideoRows(texture, image, spanFirst, spanCount);
+        for (int l = 1; l <= (int)levels.size(); l++)
+        {
+            int levelFirst = pyramid->levelRow(l, spanFirst);
+            int levelLast = pyramid->levelRow(l, spanFirst + spanCount - 1);
+            uploadVideoRows(levels[l - 1].texture, pyramid->getLevel(l), levelFirst, levelLast - levelFirst + 1);
+        }
+    };
+    int head = std::min(count, height - first);
+    uploadSpan(first, head);
+    if (count > head)
+        uploadSpan(0, count - head);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, prevAlignment);
+    markDirty(first, count);
+}
+
+void RadarVideoRenderer::uploadSwept(const RadarPolarImage &image, float fromDegrees, float toDegrees,
+                                     const RadarPolarPyramid *pyramid)
+{
+    int first, count;
+    image.sweptRows(fromDegrees, toDegrees, first, count);
+    uploadRows(image, first, count, pyramid);
+}
+
+void RadarVideoRenderer::markDirty(int first, int count)
+{
+    // a handful of spans per frame at most, beyond that convert everything
+    if (dirtyRows.size() >= 8)
+        dirtyAll = true;
+    if (!dirtyAll)
+        dirtyRows.push_back({first, count});
+}
+
+void RadarVideoRenderer::setCartesianCache(bool enabled)
+{
+    if (enabled && !cache)
+    {
+        cache = new RadarLayerCache();
+        dirtyAll = true;
+    }
+    else if (!enabled && cache)
+    {
+        delete cache;
+        cache = nullptr;
+    }
+}
+
+void RadarVideoRenderer::setSector(const RadarGeometry &geo)
+{
+    Vec2 lo, hi;
+    geo.getSectorBounds(lo, hi);
+
+    float start = geo.getSectorStart() / 360.0f;
+    float span = geo.hasSector() ? geo.getSectorWidth() / 360.0f : 1.0f;
+    if (start != sector[0] || span != sector[1])
+        dirtyAll = true;
+
+    sector[0] = start;
+    sector[1] = span;
+    bounds[0] = lo.x;
+    bounds[1] = lo.y;
+    bounds[2] = hi.x;
+    bounds[3] = hi.y;
+}
+
+void RadarVideoRenderer::dirtyRect(int w, int h, int rect[4]) const
+{
+    // one row of margin on each side for the linear filter between rows,
+    // one pixel around the box for rasterization at its edges
+    float rowDegrees = 360.0f / height;
+    Vec2 lo(1.0f, 1.0f), hi(-1.0f, -1.0f);
+    for (const RowSpan &span : dirtyRows)
+    {
+        Vec2 wedgeLo, wedgeHi;
+        RadarGeometry::getWedgeBounds((span.first - 1) * rowDegrees, (span.count + 2) * rowDegrees, wedgeLo, wedgeHi);
+        lo = Vec2(std::min(lo.x, wedgeLo.x), std::min(lo.y, wedgeLo.y));
+        hi = Vec2(std::max(hi.x, wedgeHi.x), std::max(hi.y, wedgeHi.y));
+    }
+
+    int x0 = std::max(0, (int)std::floor((lo.x + 1.0f) * 0.5f * w) - 1);
+    int y0 = std::max(0, (int)std::floor((lo.y + 1.0f) * 0.5f * h) - 1);
+    int x1 = std::min(w, (int)std::ceil((hi.x + 1.0f) * 0.5f * w) + 1);
+    int y1 = std::min(h, (int)std::ceil((hi.y + 1.0f) * 0.5f * h) + 1);
+    rect[0] = x0;
+    rect[1] = y0;
+    rect[2] = std::max(0, x1 - x0);
+    rect[3] = std::max(0, y1 - y0);
+}
+
+void RadarVideoRenderer::drawVideo()
+{
+    glUseProgram(shaderProgram);
+    glUniform4f(colorLocation, color.r, color.g, color.b, color.a);
+    glUniform2fv(sectorLocation, 1, sector);
+    glUniform4fv(boundsLocation, 1, bounds);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, drawLevel > 0 ? levels[drawLevel - 1].texture : texture);
+    glBindVertexArray(VAO);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glUseProgram(0);
+}
+
+void RadarVideoRenderer::render()
+{
+    if (width == 0)
+        return;
+
+    // pyramid level from the pixels per range bin at this viewport size
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    int level = RadarPolarPyramid::chooseLevel(std::min(viewport[2], viewport[3]) / 2.0f, width, (int)levels.size());
+    if (level != drawLevel)
+        dirtyAll = true;
+    drawLevel = level;
+
+    if (!cache)
+    {
+        dirtyRows.clear();
+        drawVideo();
+        return;
+    }
+    GLint blend[4];
+    glGetIntegerv(GL_BLEND_SRC_RGB, &blend[0]);
+    glGetIntegerv(GL_BLEND_DST_RGB, &blend[1]);
+    glGetIntegerv(GL_BLEND_SRC_ALPHA, &blend[2]);
+    glGetIntegerv(GL_BLEND_DST_ALPHA, &blend[3]);
+
+    // the layer is cleared to transparent, so blending the video into it
+    // leaves premultiplied color that composites like drawing it directly
+    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    if (dirtyAll || !cache->isValid(viewport[2], viewport[3]))
+    {
+        cache->begin(viewport[2], viewport[3]);
+        drawVideo();
+        cache->end();
+    }
+    else if (!dirtyRows.empty())
+    {
+        int rect[4];
+        dirtyRect(viewport[2], viewport[3], rect);
+        if (rect[2] > 0 && rect[3] > 0)
+        {
+            cache->beginRegion(rect[0], rect[1], rect[2], rect[3]);
+            drawVideo();
+            cache->end();
+        }
+    }
+    dirtyRows.clear();
+    dirtyAll = false;
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    glUseProgram(compositeProgram);
+    glUniform4fv(compositeBoundsLocation, 1, bounds);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, cache->getTexture());
+    glBindVertexArray(VAO);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glUseProgram(0);
+    glBlendFuncSeparate(blend[0], blend[1], blend[2], blend[3]);
+}
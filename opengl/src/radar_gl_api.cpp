@@ -1,4 +1,7 @@
 #include "radar_gl_api.h"
+#include "RadarContext.h"
+#include "RadarHandlePool.h"
+#include <algorithm>
 #include <cstring>
 #include <fstream>
 #include <mutex>
@@ -66,9 +69,61 @@ void radar_gl_deinit()
     radar_log("radar_gl_deinit");
 }
 
-RadarContext *radar_create(int rings, int radials, int segment, float sweepSpeed, float tolerance)
+// never destroyed: contexts still alive at unload hold GL objects whose
+// context is already gone, so their destructors must not run
+static RadarHandlePool<RadarContext> &contexts()
 {
-    radar_log("radar_create");
+    static auto *pool = new RadarHandlePool<RadarContext>();
+    return *pool;
+}
+
+static RadarContext *lookup(RadarHandle handle)
+{
+    return contexts().get(handle);
+}
+
+static void rebuildGrid(RadarContext *ctx, int width, int height)
+{
+    const RadarGridParams &p = ctx->gridParams;
+    ctx->gridHash = p.hash();
+    ctx->gridDirty = false;
+    if (ctx->staticLayer)
+        ctx->staticLayer->invalidate();
+
+    std::vector<RadarVertex> labels;
+    if (ctx->gridLabels)
+        labels = ctx->gridLabels->build(p.rings, p.radials, width, height, p.gridColor,
+                                        ctx->geo.getSectorStart(), ctx->geo.getSectorWidth());
+
+    // the analytic grid only reads gridParams when drawing, the radial
+    // buffer then holds just the labels
+    if (ctx->gridShader)
+    {
+        ctx->radialRenderer.upload(labels);
+        return;
+    }
+
+    auto rings = ctx->geo.generateRings(p.rings, p.segment);
+    auto radials = ctx->geo.generateRadials(p.radials, p.segment);
+    radials.insert(radials.end(), labels.begin(), labels.end());
+    ctx->ringRenderer.upload(rings);
+    ctx->radialRenderer.upload(radials);
+
+    if (ctx->gridLines)
+    {
+        rings.insert(rings.end(), radials.begin(), radials.end());
+        ctx->gridLines->upload(rings);
+    }
+}
+
+// GL objects are created on the render thread the first time they are needed,
+// so radar_create itself may run on any thread
+static void ensureGLResources(RadarContext *ctx)
+{
+    if (ctx->program)
+        return;
+
+    radar_log("radar_create GL resources");
 
     GLenum err = glGetError();
     if (err != GL_NO_ERROR)
@@ -76,32 +131,414 @@ RadarContext *radar_create(int rings, int radials, int segment, float sweepSpeed
         radar_log("GL error before X: " + std::to_string(err));
     }
 
-    auto ctx = new RadarContext;
-    ctx->geo = new RadarGeometry(sweepSpeed, 0, tolerance);
-    ctx->ringRenderer = new RadarRenderer();
-    ctx->radialRenderer = new RadarRenderer();
-    ctx->sweepRenderer = new RadarRenderer();
+    ctx->program = RadarRenderer::createProgram();
+    ctx->ringRenderer.create(ctx->program);
+    ctx->radialRenderer.create(ctx->program);
+    ctx->sweepRenderer.create(ctx->program);
+    ctx->gridDirty = true;
+    ctx->sweepDirty = true;
+}
+
+RadarHandle radar_create(int rings, int radials, int segment, float sweepSpeed, float tolerance)
+{
+    radar_log("radar_create");
+
+    RadarHandle handle = contexts().allocate(rings, radials, segment, sweepSpeed, tolerance);
+    if (!handle)
+        radar_log("radar_create: context pool is full");
+    return handle;
+}
+
+// Setters below may be called from any thread: parameters go through the
+// geometry's sequence lock, everything else is recorded as a command and
+// applied by the next radar_render on the GL thread.
+
+void radar_update_parameter(RadarHandle handle, float sweepSpeed, float tolerance)
+{
+    RadarContext *ctx = lookup(handle);
+    if (!ctx)
+        return;
+
+    RadarParameters current = ctx->geo.getParameters();
+    if (sweepSpeed == current.sweepSpeed && tolerance == current.detTolerance)
+        return;
+
+    ctx->geo.update(sweepSpeed, 0, tolerance);
+}
+
+static void pushCommand(RadarContext *ctx, const RadarCommand &cmd)
+{
+    ctx->commands[cmd.type].store(cmd);
+}
+
+void radar_update_geo(RadarHandle handle, int rings, int radials, int segment)
+{
+    RadarContext *ctx = lookup(handle);
+    if (!ctx)
+        return;
+
+    RadarCommand cmd;
+    cmd.type = RadarCommand::SetGrid;
+    cmd.grid.rings = rings;
+    cmd.grid.radials = radials;
+    cmd.grid.segment = segment;
+    pushCommand(ctx, cmd);
+}
+
+void radar_update_color(RadarHandle handle, float gridR, float gridG, float gridB, float gridA,
+                        float sweepR, float sweepG, float sweepB, float sweepA)
+{
+    RadarContext *ctx = lookup(handle);
+    if (!ctx)
+        return;
+
+    RadarCommand cmd;
+    cmd.type = RadarCommand::SetColors;
+    float colors[8] = {gridR, gridG, gridB, gridA, sweepR, sweepG, sweepB, sweepA};
+    memcpy(cmd.colors.grid, colors, sizeof(cmd.colors.grid));
+    memcpy(cmd.colors.sweep, colors + 4, sizeof(cmd.colors.sweep));
+    pushCommand(ctx, cmd);
+}
+
+void radar_set_static_cache(RadarHandle handle, int enabled)
+{
+    RadarContext *ctx = lookup(handle);
+    if (!ctx)
+        return;
+
+    RadarCommand cmd;
+    cmd.type = RadarCommand::SetStaticCache;
+    cmd.enabled = enabled;
+    pushCommand(ctx, cmd);
+}
+
+void radar_set_line_style(RadarHandle handle, float width, int msaaSamples)
+{
+    RadarContext *ctx = lookup(handle);
+    if (!ctx)
+        return;
+
+    RadarCommand cmd;
+    cmd.type = RadarCommand::SetLineStyle;
+    cmd.line.width = width;
+    cmd.line.samples = msaaSamples;
+    pushCommand(ctx, cmd);
+}
+
+void radar_set_analytic_grid(RadarHandle handle, int enabled)
+{
+    RadarContext *ctx = lookup(handle);
+    if (!ctx)
+        return;
+
+    RadarCommand cmd;
+    cmd.type = RadarCommand::SetAnalyticGrid;
+    cmd.enabled = enabled;
+    pushCommand(ctx, cmd);
+}
 
-    ctx->ringRenderer->upload(ctx->geo->generateRings(rings, segment));
-    ctx->radialRenderer->upload(ctx->geo->generateRadials(radials, segment));
+void radar_set_grid_labels(RadarHandle handle, int enabled, float range)
+{
+    RadarContext *ctx = lookup(handle);
+    if (!ctx)
+        return;
 
-    return ctx;
+    RadarCommand cmd;
+    cmd.type = RadarCommand::SetGridLabels;
+    cmd.labels.enabled = enabled;
+    cmd.labels.range = range;
+    pushCommand(ctx, cmd);
 }
 
-void radar_update_parameter(RadarContext *ctx, float sweepSpeed, float tolerance)
+void radar_set_sector(RadarHandle handle, float start, float end, int scan)
 {
+    RadarContext *ctx = lookup(handle);
     if (!ctx)
         return;
 
-    radar_log("radar_update_parameter");
-    ctx->geo->update(sweepSpeed, 0, tolerance);
+    RadarCommand cmd;
+    cmd.type = RadarCommand::SetSector;
+    cmd.sector.start = start;
+    cmd.sector.end = end;
+    cmd.sector.scan = scan;
+    pushCommand(ctx, cmd);
 }
 
-void radar_update_geo(RadarContext *ctx, int rings, int radials, int segment)
+void radar_set_video_color(RadarHandle handle, float r, float g, float b, float a)
 {
+    RadarContext *ctx = lookup(handle);
     if (!ctx)
         return;
 
+    RadarCommand cmd;
+    cmd.type = RadarCommand::SetVideoColor;
+    float color[4] = {r, g, b, a};
+    memcpy(cmd.videoColor, color, sizeof(cmd.videoColor));
+    pushCommand(ctx, cmd);
+}
+
+void radar_upload_video(RadarHandle handle, const unsigned char *rows, int azimuths, int bins, int firstRow, int rowCount)
+{
+    radar_upload_video_traced(handle, rows, azimuths, bins, firstRow, rowCount, nullptr, nullptr);
+}
+
+void radar_upload_video_traced(RadarHandle handle, const unsigned char *rows, int azimuths, int bins,
+                               int firstRow, int rowCount, const int64_t *receiveTimes, const int64_t *decodeTimes)
+{
+    RadarContext *ctx = lookup(handle);
+    if (!ctx || !rows || azimuths <= 0 || bins <= 0 || rowCount <= 0)
+        return;
+
+    if (!ctx->video)
+    {
+        radar_log("radar_upload_video");
+        ctx->video = new RadarVideoRenderer();
+        ctx->video->setColor(ctx->videoColor);
+    }
+    if (ctx->videoImage.azimuths != azimuths || ctx->videoImage.bins != bins)
+        ctx->videoImage.resize(azimuths, bins);
+
+    rowCount = std::min(rowCount, azimuths);
+    firstRow %= azimuths;
+    if (firstRow < 0)
+        firstRow += azimuths;
+    for (int k = 0; k < rowCount; k++)
+        memcpy(ctx->videoImage.row((firstRow + k) % azimuths), rows + (size_t)k * bins, bins);
+    ctx->video->uploadRows(ctx->videoImage, firstRow, rowCount);
+
+    if (!receiveTimes && !decodeTimes)
+        return;
+    RadarLatencyTracker &tracker = RadarLatencyTracker::shared();
+    RadarLatencyTracker::Frame &frame = ctx->latencyFrame;
+    int64_t uploadTime = RadarLatencyTracker::now();
+    // the frame's upload -> present starts at its first traced upload
+    if (frame.uploadTime == 0)
+        frame.uploadTime = uploadTime;
+    for (int k = 0; k < rowCount; k++)
+    {
+        int64_t received = receiveTimes ? receiveTimes[k] : 0;
+        int64_t decoded = decodeTimes ? decodeTimes[k] : 0;
+        if (received && decoded)
+            tracker.decoded(received, decoded);
+        if (decoded)
+            tracker.record(RADAR_LATENCY_UPLOAD, uploadTime - decoded);
+        if (received)
+            frame.receiveTimes.push_back(received);
+    }
+}
+
+void radar_report_azimuth(RadarHandle handle, float azimuth)
+{
+    RadarContext *ctx = lookup(handle);
+    if (!ctx)
+        return;
+
+    ctx->geo.getClock().reportAzimuth(azimuth);
+}
+
+void radar_set_phase_lock(RadarHandle handle, int enabled)
+{
+    RadarContext *ctx = lookup(handle);
+    if (!ctx)
+        return;
+
+    ctx->geo.getClock().setPhaseLock(enabled != 0);
+}
+
+void radar_update_many(const RadarUpdateDesc *descs, int count)
+{
+    if (!descs || count <= 0)
+        return;
+
+    for (int i = 0; i < count; i++)
+    {
+        const RadarUpdateDesc &d = descs[i];
+        if (!d.handle)
+            continue;
+
+        if (d.flags & RADAR_UPDATE_PARAMETER)
+            radar_update_parameter(d.handle, d.sweepSpeed, d.tolerance);
+        if (d.flags & RADAR_UPDATE_GEO)
+            radar_update_geo(d.handle, d.rings, d.radials, d.segment);
+        if (d.flags & RADAR_UPDATE_COLOR)
+            radar_update_color(d.handle, d.gridColor[0], d.gridColor[1], d.gridColor[2], d.gridColor[3],
+                               d.sweepColor[0], d.sweepColor[1], d.sweepColor[2], d.sweepColor[3]);
+        if (d.flags & RADAR_UPDATE_STATIC_CACHE)
+            radar_set_static_cache(d.handle, d.staticCache);
+    }
+}
+
+// --- render thread side, GL context is current
+
+static void applyStaticCache(RadarContext *ctx, int enabled)
+{
+    if ((enabled != 0) == (ctx->staticLayer != nullptr))
+        return;
+
+    radar_log("radar_set_static_cache");
+    if (enabled)
+    {
+        ctx->staticLayer = new RadarLayerCache();
+    }
+    else
+    {
+        delete ctx->staticLayer;
+        ctx->staticLayer = nullptr;
+    }
+}
+
+static void applyLineStyle(RadarContext *ctx, float width, int samples)
+{
+    radar_log("radar_set_line_style");
+
+    ctx->lineWidth = width > 0.0f ? width : 0.0f;
+    if (ctx->lineWidth > 0.0f && !ctx->gridLines)
+    {
+        ctx->gridLines = new RadarLineRenderer();
+        ctx->gridDirty = true;
+    }
+    else if (ctx->lineWidth == 0.0f && ctx->gridLines)
+    {
+        delete ctx->gridLines;
+        ctx->gridLines = nullptr;
+    }
+
+    ctx->msaaSamples = samples > 1 ? samples : 0;
+    if (!ctx->msaaSamples && ctx->msaa)
+    {
+        delete ctx->msaa;
+        ctx->msaa = nullptr;
+    }
+    else if (ctx->msaaSamples && !ctx->msaa)
+    {
+        ctx->msaa = new RadarMsaaTarget();
+    }
+
+    if (ctx->staticLayer)
+        ctx->staticLayer->invalidate();
+}
+
+static void applyAnalyticGrid(RadarContext *ctx, int enabled)
+{
+    if ((enabled != 0) == (ctx->gridShader != nullptr))
+        return;
+
+    radar_log("radar_set_analytic_grid");
+    if (enabled)
+    {
+        ctx->gridShader = new RadarGridShader();
+    }
+    else
+    {
+        delete ctx->gridShader;
+        ctx->gridShader = nullptr;
+    }
+
+    // switching back needs the tessellated grid again
+    ctx->gridDirty = true;
+}
+
+static void applyGridLabels(RadarContext *ctx, int enabled, float range)
+{
+    radar_log("radar_set_grid_labels");
+    if (!enabled)
+    {
+        delete ctx->gridLabels;
+        ctx->gridLabels = nullptr;
+    }
+    else if (!ctx->gridLabels)
+    {
+        ctx->gridLabels = new RadarGridLabels(range);
+    }
+    else
+    {
+        ctx->gridLabels->setRange(range);
+    }
+
+    ctx->gridDirty = true;
+}
+
+// every command sets state, so only the last one of each type is applied
+// and the grid is rebuilt at most once per frame
+static void applyCommands(RadarContext *ctx, int width, int height)
+{
+    RadarCommand latest[RadarCommand::Count];
+    bool pending[RadarCommand::Count] = {};
+
+    // a slot being written right now keeps its old version and is picked
+    // up by the next frame
+    for (uint32_t type = 0; type < RadarCommand::Count; type++)
+    {
+        uint32_t version = ctx->commands[type].version();
+        if (version == ctx->appliedCommand[type] || !ctx->commands[type].tryLoad(latest[type]))
+            continue;
+        ctx->appliedCommand[type] = version;
+        pending[type] = true;
+    }
+
+    if (pending[RadarCommand::SetStaticCache])
+        applyStaticCache(ctx, latest[RadarCommand::SetStaticCache].enabled);
+    if (pending[RadarCommand::SetAnalyticGrid])
+        applyAnalyticGrid(ctx, latest[RadarCommand::SetAnalyticGrid].enabled);
+    if (pending[RadarCommand::SetLineStyle])
+        applyLineStyle(ctx, latest[RadarCommand::SetLineStyle].line.width, latest[RadarCommand::SetLineStyle].line.samples);
+    if (pending[RadarCommand::SetGridLabels])
+        applyGridLabels(ctx, latest[RadarCommand::SetGridLabels].labels.enabled, latest[RadarCommand::SetGridLabels].labels.range);
+
+    RadarGridParams params = ctx->gridParams;
+    if (pending[RadarCommand::SetGrid])
+    {
+        const RadarCommand &c = latest[RadarCommand::SetGrid];
+        params.rings = c.grid.rings;
+        params.radials = c.grid.radials;
+        params.segment = c.grid.segment;
+    }
+
+    if (pending[RadarCommand::SetSector])
+    {
+        const RadarCommand &c = latest[RadarCommand::SetSector];
+        if (c.sector.start != params.sectorStart || c.sector.end != params.sectorEnd || c.sector.scan != params.sectorScan)
+        {
+            radar_log("radar_set_sector");
+            params.sectorStart = c.sector.start;
+            params.sectorEnd = c.sector.end;
+            params.sectorScan = c.sector.scan;
+            ctx->geo.setSector(params.sectorStart, params.sectorEnd, params.sectorScan != 0);
+            ctx->sweepDirty = true;
+        }
+    }
+
+    if (pending[RadarCommand::SetVideoColor])
+    {
+        const float *c = latest[RadarCommand::SetVideoColor].videoColor;
+        ctx->videoColor = Vec4(c[0], c[1], c[2], c[3]);
+        if (ctx->video)
+            ctx->video->setColor(ctx->videoColor);
+    }
+
+    if (pending[RadarCommand::SetColors])
+    {
+        const float *grid = latest[RadarCommand::SetColors].colors.grid;
+        const float *sweep = latest[RadarCommand::SetColors].colors.sweep;
+        Vec4 sweepColor(sweep[0], sweep[1], sweep[2], sweep[3]);
+        Vec4 oldSweep = ctx->geo.getSweepColor();
+
+        params.gridColor = Vec4(grid[0], grid[1], grid[2], grid[3]);
+        if (memcmp(&sweepColor, &oldSweep, sizeof(Vec4)) != 0)
+        {
+            radar_log("radar_update_color");
+            ctx->sweepDirty = true;
+        }
+        ctx->geo.setColors(params.gridColor, sweepColor);
+    }
+
+    // labels also follow the scope size, re-laid out when it leaves its zoom bucket
+    bool labelsCurrent = !ctx->gridLabels ||
+                         ctx->gridLabels->isCurrent(params.rings, params.radials, width, height, params.gridColor,
+                                                    ctx->geo.getSectorStart(), ctx->geo.getSectorWidth());
+    if (params.hash() == ctx->gridHash && !ctx->gridDirty && labelsCurrent)
+        return;
+
     radar_log("radar_update_geo");
 
     GLenum err = glGetError();
@@ -110,12 +547,106 @@ void radar_update_geo(RadarContext *ctx, int rings, int radials, int segment)
         radar_log("GL error before X: " + std::to_string(err));
     }
 
-    ctx->ringRenderer->upload(ctx->geo->generateRings(rings, segment));
-    ctx->radialRenderer->upload(ctx->geo->generateRadials(radials, segment));
+    ctx->gridParams = params;
+    rebuildGrid(ctx, width, height);
+}
+
+static void drawGrid(RadarContext *ctx, int width, int height)
+{
+    if (ctx->gridShader)
+    {
+        const RadarGridParams &p = ctx->gridParams;
+        float lineWidth = ctx->lineWidth > 0.0f ? ctx->lineWidth : 1.0f;
+        ctx->gridShader->setSector(ctx->geo);
+        ctx->gridShader->render(p.rings, p.radials, RadarGeometry::RING_SPACING, p.gridColor, lineWidth);
+        if (ctx->gridLabels)
+            ctx->radialRenderer.render(GL_LINES);
+        return;
+    }
+
+    if (ctx->gridLines)
+    {
+        ctx->gridLines->render(ctx->lineWidth, width, height);
+        return;
+    }
+
+    ctx->ringRenderer.render(GL_LINES);
+    ctx->radialRenderer.render(GL_LINES);
 }
 
-float radar_render(RadarContext *ctx, int width, int height, double deltaTime)
+// draws one scope into the (x, y, width, height) region of the bound framebuffer
+static float renderScope(RadarContext *ctx, int x, int y, int width, int height, double deltaTime)
 {
+    ensureGLResources(ctx);
+    applyCommands(ctx, width, height);
+
+    // with MSAA the scope is drawn at the origin of the multisampled target
+    // and resolved into its region at the end; a multisampled target cannot
+    // be blitted into, so the static layer is bypassed meanwhile
+    RadarLayerCache *staticLayer = ctx->msaa ? nullptr : ctx->staticLayer;
+    int drawX = ctx->msaa ? 0 : x;
+    int drawY = ctx->msaa ? 0 : y;
+
+    // grid is only redrawn after a resize or parameter change
+    if (staticLayer && !staticLayer->isValid(width, height))
+    {
+        staticLayer->begin(width, height);
+        drawGrid(ctx, width, height);
+        staticLayer->end();
+    }
+
+    if (ctx->msaa)
+        ctx->msaa->begin(width, height, ctx->msaaSamples);
+
+    // clear only this scope's region, others may share the framebuffer
+    glViewport(drawX, drawY, width, height);
+    glScissor(drawX, drawY, width, height);
+    glEnable(GL_SCISSOR_TEST);
+
+    if (staticLayer)
+    {
+        glClear(GL_DEPTH_BUFFER_BIT);
+        staticLayer->blit(drawX, drawY, width, height);
+    }
+    else
+    {
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        drawGrid(ctx, width, height);
+    }
+
+    // video between grid and sweep, limited to the current sector
+    if (ctx->video)
+    {
+        ctx->video->setSector(ctx->geo);
+        ctx->video->render();
+    }
+
+    // sweep vertices only change when the angle, tolerance or color does
+    float angle = ctx->geo.advanceSweep(deltaTime);
+    uint32_t paramVersion = ctx->geo.getParameterVersion();
+    if (ctx->sweepDirty || angle != ctx->lastSweepAngle || paramVersion != ctx->lastParamVersion)
+    {
+        ctx->sweepRenderer.upload(ctx->geo.generateStoppedSweep(angle));
+        ctx->lastSweepAngle = angle;
+        ctx->lastParamVersion = paramVersion;
+        ctx->sweepDirty = false;
+    }
+    ctx->sweepRenderer.render(GL_TRIANGLE_FAN);
+
+    if (ctx->msaa)
+    {
+        glScissor(x, y, width, height);
+        ctx->msaa->resolve(x, y);
+        glViewport(x, y, width, height);
+    }
+
+    glDisable(GL_SCISSOR_TEST);
+    return ctx->geo.getSweepAngle();
+}
+
+float radar_render(RadarHandle handle, int width, int height, double deltaTime)
+{
+    RadarContext *ctx = lookup(handle);
     if (!ctx)
         return 0.0f;
 
@@ -125,29 +656,144 @@ float radar_render(RadarContext *ctx, int width, int height, double deltaTime)
         radar_log("GL error before X: " + std::to_string(err));
     }
 
-    glViewport(0, 0, width, height);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    return renderScope(ctx, 0, 0, width, height, deltaTime);
+}
+
+int radar_render_many(const RadarRenderDesc *descs, int count, float *outAngles)
+{
+    if (!descs || count <= 0)
+        return 0;
+
+    GLenum err = glGetError();
+    if (err != GL_NO_ERROR)
+    {
+        radar_log("GL error before X: " + std::to_string(err));
+    }
+
+    int rendered = 0;
+    for (int i = 0; i < count; i++)
+    {
+        const RadarRenderDesc &d = descs[i];
+        float angle = 0.0f;
+        if (RadarContext *ctx = lookup(d.handle))
+        {
+            angle = renderScope(ctx, d.x, d.y, d.width, d.height, d.deltaTime);
+            rendered++;
+        }
+        if (outAngles)
+            outAngles[i] = angle;
+    }
+    return rendered;
+}
+
+int radar_export_frame(RadarHandle handle, RadarFrameExport *exporter, int width, int height)
+{
+    RadarContext *ctx = lookup(handle);
+    if (!ctx || !exporter || width <= 0 || height <= 0)
+        return 0;
+
+    size_t bytes = (size_t)width * height * 4;
+    if (bytes > exporter->getSlotSize())
+    {
+        radar_log("radar_export_frame: " + std::to_string(width) + "x" + std::to_string(height) + " does not fit a slot");
+        return 0;
+    }
+
+    RadarFrameSlotHeader *slot = exporter->beginWrite(RADAR_FRAME_RGBA);
+    if (!slot)
+        return 0;
+
+    // pixels go straight into shared memory, no staging copy; RGBA rows are
+    // always 4-byte aligned so the default pack alignment applies
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, exporter->payload(slot));
+
+    slot->width = (uint32_t)width;
+    slot->height = (uint32_t)height;
+    slot->size = (uint32_t)bytes;
+    slot->angle = ctx->geo.getSweepAngle();
+    exporter->endWrite(slot);
+    return 1;
+}
+
+void radar_present(RadarHandle handle)
+{
+    RadarContext *ctx = lookup(handle);
+    if (!ctx)
+        return;
+
+    // the probe records into this library's tracker, the one radar_latency_* reads
+    if (!ctx->presentProbe)
+        ctx->presentProbe = new RadarPresentProbe();
+    ctx->presentProbe->submit(std::move(ctx->latencyFrame));
+    ctx->latencyFrame = RadarLatencyTracker::Frame();
+}
+
+int radar_latency_stats(int stage, RadarLatencyStats *out)
+{
+    if (stage < 0 || stage >= RADAR_LATENCY_STAGES || !out)
+        return 0;
+
+    RadarLatencyHistogram::Summary s = RadarLatencyTracker::shared().getStage((RadarLatencyStage)stage).summarize();
+    out->count = s.count;
+    out->meanMs = s.meanMs;
+    out->p50Ms = s.p50Ms;
+    out->p95Ms = s.p95Ms;
+    out->p99Ms = s.p99Ms;
+    out->maxMs = s.maxMs;
+    return 1;
+}
+
+int radar_latency_histogram(int stage, uint64_t *counts, double *upperMs, int maxBuckets)
+{
+    if (stage < 0 || stage >= RADAR_LATENCY_STAGES)
+        return 0;
 
-    float baseSize = 600.0f;
-    float scale = (float)width / baseSize;
+    const RadarLatencyHistogram &h = RadarLatencyTracker::shared().getStage((RadarLatencyStage)stage);
+    int n = std::min(maxBuckets, RadarLatencyHistogram::BUCKETS);
+    for (int b = 0; b < n; b++)
+    {
+        if (counts)
+            counts[b] = h.getBucket(b);
+        if (upperMs)
+            upperMs[b] = RadarLatencyHistogram::bucketUpperMs(b);
+    }
+    return std::max(n, 0);
+}
 
-    ctx->ringRenderer->render(GL_LINES);
-    ctx->radialRenderer->render(GL_LINES);
-    ctx->sweepRenderer->upload(ctx->geo->generateSweep(deltaTime));
-    ctx->sweepRenderer->render(GL_TRIANGLE_FAN);
+void radar_latency_record(int stage, int64_t nanos)
+{
+    if (stage >= 0 && stage < RADAR_LATENCY_STAGES)
+        RadarLatencyTracker::shared().record((RadarLatencyStage)stage, nanos);
+}
 
-    return ctx->geo->getSweepAngle();
+void radar_latency_reset()
+{
+    RadarLatencyTracker::shared().reset();
 }
 
-void radar_destroy(RadarContext *ctx)
+// must run on the GL thread, after the last radar_render for this context;
+// the handle and any copies of it are invalid afterwards
+void radar_destroy(RadarHandle handle)
 {
+    RadarContext *ctx = lookup(handle);
     if (!ctx)
+    {
+        if (handle)
+            radar_log("radar_destroy: stale handle " + std::to_string(handle));
         return;
+    }
 
     radar_log("radar_destroy");
-    delete ctx->geo;
-    delete ctx->ringRenderer;
-    delete ctx->radialRenderer;
-    delete ctx->sweepRenderer;
-    delete ctx;
+    delete ctx->staticLayer;
+    delete ctx->gridLines;
+    delete ctx->gridShader;
+    delete ctx->gridLabels;
+    delete ctx->msaa;
+    delete ctx->video;
+    delete ctx->presentProbe;
+    // renderers are destroyed with the context, before the program they share
+    unsigned int program = ctx->program;
+    contexts().release(handle);
+    if (program)
+        glDeleteProgram(program);
 }
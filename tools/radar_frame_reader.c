@@ -0,0 +1,279 @@
+/*
+ * Plain C reader of the shared-memory frame ring (RadarFrameRing.h), the
+ * way a consumer in another process or language would read it: map the
+ * region, follow the per-slot sequence lock and check every frame it
+ * accepts. Run it against a live writer, e.g. radar_frame_writer:
+ *
+ *   radar_frame_writer radar_frames 200000 &
+ *   radar_frame_reader radar_frames --pattern
+ *
+ * usage: radar_frame_reader <name> [--pattern] [seconds]
+ *   --pattern  payloads carry radar_frame_writer's test pattern, check it
+ *   seconds    stop after this long (default 30), or 1 s after the writer stops
+ *
+ * exit status: 0 all frames consistent, 1 a torn or corrupt frame was
+ * accepted, 2 the ring could not be opened or had no frames
+ */
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L /* shm_open, clock_gettime, nanosleep in strict C */
+#endif
+
+#include "RadarFrameRing.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+/* the sequence and published words are written atomically by the writer */
+#if defined(_MSC_VER)
+#include <intrin.h>
+static uint32_t load_acquire_u32(const volatile uint32_t *p)
+{
+    uint32_t v = *p;
+    _ReadWriteBarrier();
+    return v;
+}
+static uint64_t load_acquire_u64(const volatile uint64_t *p)
+{
+    uint64_t v = *p;
+    _ReadWriteBarrier();
+    return v;
+}
+static void fence_acquire(void) { _ReadWriteBarrier(); }
+#else
+static uint32_t load_acquire_u32(const uint32_t *p) { return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+static uint64_t load_acquire_u64(const uint64_t *p) { return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+static void fence_acquire(void) { __atomic_thread_fence(__ATOMIC_ACQUIRE); }
+#endif
+
+/* word i of frame f written by radar_frame_writer */
+static uint32_t pattern_word(uint64_t frameId, uint32_t i) { return (uint32_t)frameId * 0x9E3779B1u + i; }
+
+static double now_seconds(void)
+{
+#ifdef _WIN32
+    return (double)GetTickCount64() / 1000.0;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+#endif
+}
+
+static void sleep_ms(int ms)
+{
+#ifdef _WIN32
+    Sleep((DWORD)ms);
+#else
+    struct timespec ts = {ms / 1000, (long)(ms % 1000) * 1000000L};
+    nanosleep(&ts, NULL);
+#endif
+}
+
+/* maps the whole region, read-write like RadarSharedRegion; NULL when it does not exist yet */
+static uint8_t *map_ring(const char *name, size_t *size)
+{
+    char path[256];
+#ifdef _WIN32
+    HANDLE handle;
+    MEMORY_BASIC_INFORMATION info;
+    uint8_t *base;
+    snprintf(path, sizeof(path), "Local\\%s", name);
+    handle = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, path);
+    if (!handle)
+        return NULL;
+    base = (uint8_t *)MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+    /* the view keeps the mapping alive */
+    CloseHandle(handle);
+    if (!base || !VirtualQuery(base, &info, sizeof(info)))
+        return NULL;
+    *size = info.RegionSize;
+    return base;
+#else
+    struct stat st;
+    void *ptr;
+    int fd;
+    snprintf(path, sizeof(path), "/%s", name);
+    fd = shm_open(path, O_RDWR, 0);
+    if (fd < 0)
+        return NULL;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(struct RadarFrameRingHeader))
+    {
+        close(fd);
+        return NULL;
+    }
+    ptr = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (ptr == MAP_FAILED)
+        return NULL;
+    *size = (size_t)st.st_size;
+    return (uint8_t *)ptr;
+#endif
+}
+
+/* checks one frame copied under a stable sequence, returns an error message or NULL */
+static const char *check_frame(const struct RadarFrameRingHeader *ring, uint64_t slotIndex,
+                               const struct RadarFrameSlotHeader *h, const uint8_t *payload, int pattern)
+{
+    uint32_t words, i;
+    if (h->frameId == 0 || (h->frameId - 1) % ring->slotCount != slotIndex)
+        return "frame id does not belong to its slot";
+    if (h->size > ring->slotSize)
+        return "payload larger than the slot";
+    if (h->kind == RADAR_FRAME_RGBA)
+    {
+        if ((uint64_t)h->width * h->height * 4 != h->size)
+            return "RGBA size does not match width x height";
+    }
+    else if (h->kind == RADAR_FRAME_GEOMETRY)
+    {
+        if ((uint64_t)h->count * 6 * sizeof(float) != h->size)
+            return "geometry size does not match the vertex count";
+    }
+    else
+        return "unknown frame kind";
+
+    if (!pattern)
+        return NULL;
+    words = h->size / 4;
+    for (i = 0; i < words; i++)
+    {
+        uint32_t word;
+        memcpy(&word, payload + (size_t)i * 4, 4);
+        if (word != pattern_word(h->frameId, i))
+            return "payload does not match the frame id (torn frame)";
+    }
+    return NULL;
+}
+
+int main(int argc, char **argv)
+{
+    const char *name = NULL;
+    int pattern = 0;
+    double seconds = 30.0;
+    int i;
+    size_t size = 0;
+    uint8_t *base = NULL;
+    const struct RadarFrameRingHeader *ring;
+    uint8_t *slots;
+    uint8_t *copy;
+    double start, lastNew;
+    uint64_t lastFrame = 0, frames = 0, retries = 0, skipped = 0;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--pattern") == 0)
+            pattern = 1;
+        else if (!name)
+            name = argv[i];
+        else
+            seconds = atof(argv[i]);
+    }
+    if (!name)
+    {
+        fprintf(stderr, "usage: radar_frame_reader <name> [--pattern] [seconds]\n");
+        return 2;
+    }
+
+    /* the writer may still be starting */
+    start = now_seconds();
+    while (!(base = map_ring(name, &size)) || ((const struct RadarFrameRingHeader *)base)->magic != RADAR_FRAME_RING_MAGIC)
+    {
+        if (now_seconds() - start > 5.0)
+        {
+            fprintf(stderr, "radar_frame_reader: no frame ring named %s\n", name);
+            return 2;
+        }
+        sleep_ms(10);
+    }
+    fence_acquire();
+
+    ring = (const struct RadarFrameRingHeader *)base;
+    if (ring->version != RADAR_FRAME_RING_VERSION || ring->slotCount == 0 ||
+        ring->slotStride < sizeof(struct RadarFrameSlotHeader) + ring->slotSize ||
+        sizeof(struct RadarFrameRingHeader) + (size_t)ring->slotStride * ring->slotCount > size)
+    {
+        fprintf(stderr, "radar_frame_reader: %s has an unexpected layout\n", name);
+        return 2;
+    }
+    printf("%s: %u slots of %u bytes\n", name, ring->slotCount, ring->slotSize);
+
+    slots = base + sizeof(struct RadarFrameRingHeader);
+    copy = (uint8_t *)malloc(ring->slotSize > 0 ? ring->slotSize : 1);
+    start = lastNew = now_seconds();
+    while (now_seconds() - start < seconds)
+    {
+        struct RadarFrameSlotHeader h;
+        const struct RadarFrameSlotHeader *slot;
+        uint64_t published, slotIndex;
+        uint32_t seq;
+        const char *error;
+
+        published = load_acquire_u64(&ring->published);
+        if (published == lastFrame)
+        {
+            /* the writer has stopped */
+            if (lastFrame > 0 && now_seconds() - lastNew > 1.0)
+                break;
+            sleep_ms(0);
+            continue;
+        }
+
+        /* 1. sequence, odd while written */
+        slotIndex = (published - 1) % ring->slotCount;
+        slot = (const struct RadarFrameSlotHeader *)(slots + slotIndex * ring->slotStride);
+        seq = load_acquire_u32(&slot->sequence);
+        if (seq & 1)
+        {
+            retries++;
+            continue;
+        }
+
+        /* 2. header and payload */
+        memcpy(&h, slot, sizeof(h));
+        if (h.size <= ring->slotSize)
+            memcpy(copy, slot + 1, h.size);
+
+        /* 3. unchanged sequence, or the copy may be torn */
+        fence_acquire();
+        if (load_acquire_u32(&slot->sequence) != seq)
+        {
+            retries++;
+            continue;
+        }
+
+        error = check_frame(ring, slotIndex, &h, copy, pattern);
+        if (!error && h.frameId < lastFrame)
+            error = "frame id went backwards";
+        if (error)
+        {
+            fprintf(stderr, "radar_frame_reader: frame %llu (slot %llu, sequence %u): %s\n",
+                    (unsigned long long)h.frameId, (unsigned long long)slotIndex, seq, error);
+            free(copy);
+            return 1;
+        }
+
+        if (lastFrame > 0 && h.frameId > lastFrame + 1)
+            skipped += h.frameId - lastFrame - 1;
+        lastFrame = h.frameId;
+        lastNew = now_seconds();
+        frames++;
+    }
+    free(copy);
+
+    printf("%llu frames checked, %llu skipped by the writer, %llu retries, last frame %llu\n",
+           (unsigned long long)frames, (unsigned long long)skipped, (unsigned long long)retries,
+           (unsigned long long)lastFrame);
+    return frames > 0 ? 0 : 2;
+}
@@ -0,0 +1,62 @@
+#include "RadarFrameExport.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+// Writes RGBA test frames into a shared-memory frame ring as fast as it
+// can, each payload a pattern derived from its frame id, so a concurrent
+// radar_frame_reader --pattern can tell a torn frame from a good one.
+// Few slots keep the writer on top of the reader, the case the sequence
+// locks are there for.
+//
+// usage: radar_frame_writer <name> [frames] [slots] [width] [height]
+
+// word i of frame f, also in radar_frame_reader.c
+static uint32_t patternWord(uint64_t frameId, uint32_t i)
+{
+    return (uint32_t)frameId * 0x9E3779B1u + i;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: radar_frame_writer <name> [frames] [slots] [width] [height]\n");
+        return 2;
+    }
+    const char *name = argv[1];
+    long long frames = argc > 2 ? atoll(argv[2]) : 100000;
+    int slots = argc > 3 ? atoi(argv[3]) : 2;
+    int width = argc > 4 ? atoi(argv[4]) : 64;
+    int height = argc > 5 ? atoi(argv[5]) : 64;
+
+    size_t bytes = (size_t)width * height * 4;
+    RadarFrameExport exporter;
+    if (!exporter.create(name, slots, bytes))
+        return 2;
+
+    auto start = std::chrono::steady_clock::now();
+    for (long long k = 0; k < frames; k++)
+    {
+        RadarFrameSlotHeader *slot = exporter.beginWrite(RADAR_FRAME_RGBA);
+        uint8_t *payload = exporter.payload(slot);
+        for (uint32_t i = 0; i < bytes / 4; i++)
+        {
+            uint32_t word = patternWord(slot->frameId, i);
+            memcpy(payload + (size_t)i * 4, &word, 4);
+        }
+        slot->width = (uint32_t)width;
+        slot->height = (uint32_t)height;
+        slot->size = (uint32_t)bytes;
+        exporter.endWrite(slot);
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    printf("%lld frames of %zu bytes in %.1f ms\n", frames, bytes, ms);
+
+    // readers notice the writer stopping before the ring is unlinked
+    std::this_thread::sleep_for(std::chrono::seconds(2));
+    exporter.close();
+    return 0;
+}
@@ -0,0 +1,309 @@
+#include "RadarRecorder.h"
+#include "RadarSceneGenerator.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+typedef int SOCKET;
+#define INVALID_SOCKET (-1)
+#define closesocket close
+#endif
+
+// Synthetic scene load generator: sends RadarSceneGenerator spokes to a
+// listener over UDP at a fixed rate (or as fast as the socket takes them),
+// or writes them to a recording for --replay.
+//
+// --host <ip>       destination, IPv4 or IPv6, unicast or multicast, default 127.0.0.1
+// --port <n>        destination port, default 5555
+// --rate <n>        spokes per second, default the antenna's rate, 0 unpaced
+// --duration <s>    stop after this many seconds, default 10
+// --count <n>       stop after this many spokes instead
+// --record <file>   write a recording instead of sending (unpaced)
+// --epoch <ns>      first timestamp of a recording, default 0
+// --repeat          generate one revolution up front and resend it, for
+//                   rates above what generation keeps up with
+// scene: --seed <n> --radar-id <n> --spokes <per turn> --bins <n> --rpm <x>
+//        --noise <x> --clutter <x> --sea <0-9> --targets <n> --speed <x> --raw
+
+static int64_t wallClockNanos()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+struct Options
+{
+    RadarSceneGenerator::Config scene;
+    std::string host = "127.0.0.1";
+    int port = 5555;
+    double rate = -1.0; // antenna rate unless set
+    double duration = 10.0;
+    long long count = -1;
+    std::string recordPath;
+    int64_t epoch = 0;
+    bool repeat = false;
+};
+
+static bool parseOptions(int argc, char **argv, Options &o)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        const char *value = hasValue ? argv[i + 1] : "";
+
+        if (arg == "--repeat")
+            o.repeat = true;
+        else if (arg == "--raw")
+            o.scene.encoding = RADAR_SPOKE_RAW8;
+        else if (!hasValue)
+        {
+            fprintf(stderr, "missing value for %s\n", arg.c_str());
+            return false;
+        }
+        else if (arg == "--host")
+            o.host = value;
+        else if (arg == "--port")
+            o.port = atoi(value);
+        else if (arg == "--rate")
+            o.rate = atof(value);
+        else if (arg == "--duration")
+            o.duration = atof(value);
+        else if (arg == "--count")
+            o.count = atoll(value);
+        else if (arg == "--record")
+            o.recordPath = value;
+        else if (arg == "--epoch")
+            o.epoch = atoll(value);
+        else if (arg == "--seed")
+            o.scene.seed = strtoull(value, nullptr, 10);
+        else if (arg == "--radar-id")
+            o.scene.radarId = (uint16_t)atoi(value);
+        else if (arg == "--spokes")
+            o.scene.spokesPerRevolution = atoi(value);
+        else if (arg == "--bins")
+            o.scene.bins = atoi(value);
+        else if (arg == "--rpm")
+            o.scene.rpm = (float)atof(value);
+        else if (arg == "--noise")
+            o.scene.noise = (float)atof(value);
+        else if (arg == "--clutter")
+            o.scene.clutter = (float)atof(value);
+        else if (arg == "--sea")
+            o.scene.seaState = atoi(value);
+        else if (arg == "--targets")
+            o.scene.targets = atoi(value);
+        else if (arg == "--speed")
+            o.scene.maxSpeed = (float)atof(value);
+        else
+        {
+            fprintf(stderr, "unknown option %s\n", arg.c_str());
+            return false;
+        }
+        i++;
+    }
+    return true;
+}
+
+// packets of one revolution for --repeat, sequence and timestamp patched on send
+struct Revolution
+{
+    std::vector<uint8_t> data;
+    std::vector<size_t> offsets;
+    std::vector<size_t> sizes;
+};
+
+static void report(const char *what, long long spokes, uint64_t bytes, double seconds)
+{
+    printf("%s %lld spokes in %.2f s: %.0f spokes/s, %.1f Mbit/s\n", what, spokes, seconds, spokes / seconds,
+           bytes * 8.0 / seconds / 1e6);
+}
+
+static int writeRecording(const Options &o, RadarSceneGenerator &scene)
+{
+    RadarRecorder recorder;
+    if (!recorder.open(o.recordPath))
+    {
+        fprintf(stderr, "cannot open %s\n", o.recordPath.c_str());
+        return 1;
+    }
+
+    // timestamps follow scene time, so the same options give the same file
+    long long count = o.count >= 0 ? o.count : (long long)(o.duration / scene.getSpokeInterval());
+    std::vector<uint8_t> packet(scene.maxPacketSize());
+    uint64_t bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (long long k = 0; k < count; k++)
+    {
+        int64_t timestamp = o.epoch + (int64_t)(k * scene.getSpokeInterval() * 1e9);
+        size_t size = scene.spoke((uint32_t)k, timestamp, packet.data());
+        recorder.write(packet.data(), (uint32_t)size, timestamp);
+        bytes += size;
+    }
+    recorder.close();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    report("recorded", count, bytes, seconds);
+    return 0;
+}
+
+static int sendUdp(const Options &o, RadarSceneGenerator &scene)
+{
+    bool v6 = o.host.find(':') != std::string::npos;
+    SOCKET sock = socket(v6 ? AF_INET6 : AF_INET, SOCK_DGRAM, 0);
+    if (sock == INVALID_SOCKET)
+    {
+        fprintf(stderr, "socket failed\n");
+        return 1;
+    }
+    int sendBuffer = 8 << 20;
+    setsockopt(sock, SOL_SOCKET, SO_SNDBUF, (const char *)&sendBuffer, sizeof(sendBuffer));
+
+    sockaddr_storage dest{};
+    socklen_t destLen;
+    int parsed;
+    if (v6)
+    {
+        sockaddr_in6 *a = (sockaddr_in6 *)&dest;
+        a->sin6_family = AF_INET6;
+        a->sin6_port = htons((uint16_t)o.port);
+        parsed = inet_pton(AF_INET6, o.host.c_str(), &a->sin6_addr);
+        destLen = sizeof(sockaddr_in6);
+    }
+    else
+    {
+        sockaddr_in *a = (sockaddr_in *)&dest;
+        a->sin_family = AF_INET;
+        a->sin_port = htons((uint16_t)o.port);
+        parsed = inet_pton(AF_INET, o.host.c_str(), &a->sin_addr);
+        destLen = sizeof(sockaddr_in);
+    }
+    if (parsed != 1)
+    {
+        fprintf(stderr, "bad host %s\n", o.host.c_str());
+        closesocket(sock);
+        return 1;
+    }
+
+    double rate = o.rate >= 0.0 ? o.rate : 1.0 / scene.getSpokeInterval();
+    long long count = o.count >= 0 ? o.count : (rate > 0.0 ? (long long)(o.duration * rate) : -1);
+
+    Revolution revolution;
+    int spokes = scene.getConfig().spokesPerRevolution;
+    if (o.repeat)
+    {
+        std::vector<uint8_t> packet(scene.maxPacketSize());
+        for (int k = 0; k < spokes; k++)
+        {
+            size_t size = scene.spoke((uint32_t)k, 0, packet.data());
+            revolution.offsets.push_back(revolution.data.size());
+            revolution.sizes.push_back(size);
+            revolution.data.insert(revolution.data.end(), packet.begin(), packet.begin() + size);
+        }
+    }
+
+    printf("sending to %s:%d at %s spokes/s\n", o.host.c_str(), o.port,
+           rate > 0.0 ? std::to_string((long long)rate).c_str() : "unpaced");
+
+    // spoke k is due at start + k / rate; sleeping per batch of ~1 ms keeps
+    // the syscall and wakeup count down at high rates
+    std::vector<uint8_t> packet(scene.maxPacketSize());
+    long long batch = rate > 0.0 ? std::max(1LL, (long long)(rate / 1000.0)) : 64;
+    auto start = std::chrono::steady_clock::now();
+    // --count replaces the duration limit
+    auto deadline = o.count >= 0 ? std::chrono::steady_clock::time_point::max()
+                                 : start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                               std::chrono::duration<double>(o.duration));
+    auto lastReport = start;
+    long long sent = 0, dropped = 0, reportedSent = 0;
+    uint64_t bytes = 0, reportedBytes = 0;
+
+    while ((count < 0 || sent < count) && std::chrono::steady_clock::now() < deadline)
+    {
+        if (rate > 0.0)
+            std::this_thread::sleep_until(start + std::chrono::duration<double>(sent / rate));
+
+        for (long long b = 0; b < batch && (count < 0 || sent < count); b++)
+        {
+            uint32_t sequence = (uint32_t)sent;
+            const uint8_t *data = packet.data();
+            size_t size;
+            if (o.repeat)
+            {
+                uint8_t *p = revolution.data.data() + revolution.offsets[sequence % spokes];
+                size = revolution.sizes[sequence % spokes];
+                // same spoke content, new sequence number and send time
+                RadarSpokeHeader header;
+                memcpy(&header, p, sizeof(header));
+                header.sequence = sequence;
+                header.timestamp = wallClockNanos();
+                memcpy(p, &header, sizeof(header));
+                data = p;
+            }
+            else
+            {
+                size = scene.spoke(sequence, wallClockNanos(), packet.data());
+            }
+
+            if (sendto(sock, (const char *)data, (int)size, 0, (const sockaddr *)&dest, destLen) < 0)
+                dropped++;
+            bytes += size;
+            sent++;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        double sinceReport = std::chrono::duration<double>(now - lastReport).count();
+        if (sinceReport >= 1.0)
+        {
+            report("  ", sent - reportedSent, bytes - reportedBytes, sinceReport);
+            lastReport = now;
+            reportedSent = sent;
+            reportedBytes = bytes;
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    report("sent", sent, bytes, seconds);
+    if (dropped)
+        printf("%lld sends failed (socket buffer full)\n", dropped);
+    closesocket(sock);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+        return 2;
+
+    RadarSceneGenerator scene(options.scene);
+    const RadarSceneGenerator::Config &c = scene.getConfig();
+    printf("scene seed %llu: %d spokes x %d bins, %.1f rpm, %d targets, sea state %d\n",
+           (unsigned long long)c.seed, c.spokesPerRevolution, c.bins, c.rpm, c.targets, c.seaState);
+
+    if (!options.recordPath.empty())
+        return writeRecording(options, scene);
+
+#ifdef _WIN32
+    WSADATA wsaData;
+    WSAStartup(MAKEWORD(2, 2), &wsaData);
+#endif
+    int result = sendUdp(options, scene);
+#ifdef _WIN32
+    WSACleanup();
+#endif
+    return result;
+}